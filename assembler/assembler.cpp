@@ -3,42 +3,88 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
 
 #include "src/pre-process/pre-processor.hpp"
+#include "src/pre-process/include-cache.hpp"
 #include "src/messages/list.hpp"
 extern "C" {
 #include "util.h"
 }
 #include "assembler_data.hpp"
+#include "binary_io.hpp"
+#include "incremental.hpp"
+#include "optimiser.hpp"
 #include "parser.hpp"
 
 struct Options {
-    char *input_file;
+    std::vector<char *> input_files;
     char *output_file;
     char *post_processing_file;
     bool debug;
     bool strict_sections;
     bool do_compilation;
     bool do_pre_processing;
+    char *lib_cache;
+    char *incremental;
+    int max_warnings;
+    bool object_file;
+    bool optimise;
+    bool symbols;
+    int jobs;
+    bool serve;
 
     Options() {
-        input_file = nullptr;
         output_file = nullptr;
         post_processing_file = nullptr;
         debug = false;
         strict_sections = false;
         do_compilation = true;
         do_pre_processing = true;
+        lib_cache = nullptr;
+        incremental = nullptr;
+        max_warnings = 0;
+        object_file = false;
+        optimise = false;
+        symbols = false;
+        jobs = 0;
+        serve = false;
     }
 };
 
+/** Guards output, as files may be assembled in parallel. */
+std::mutex output_mutex;
+
+/** Print a line of output. Files may be assembled in parallel, so lines are printed whole. */
+void print_line(const std::string &line) {
+    std::lock_guard<std::mutex> lock(output_mutex);
+    std::cout << line << "\n";
+}
+
 /** Handle message list: print messages and empty the list, return if there was an error. */
 bool handle_messages(message::List& list) {
+    std::lock_guard<std::mutex> lock(output_mutex);
+
     list.for_each_message([] (message::Message &msg) {
         msg.print();
     });
 
-    bool is_error = list.has_message_of(message::Level::Error);
+    if (list.get_suppressed_count() > 0) {
+        std::cout << list.get_suppressed_count() << " more warning(s) not shown\n";
+    }
+
+    bool is_error = list.has_errors();
 
     list.clear();
 
@@ -60,6 +106,19 @@ int parse_arguments(int argc, char **argv, Options &opts) {
                 }
 
                 opts.output_file = argv[i];
+            } else if (argv[i][1] == 'c' && !opts.object_file) { // Assemble to object files
+                opts.object_file = true;
+            } else if (argv[i][1] == 'O' && !opts.optimise) { // Run the peephole optimiser
+                opts.optimise = true;
+            } else if (argv[i][1] == 'g' && !opts.symbols) { // Write debug symbols
+                opts.symbols = true;
+            } else if (argv[i][1] == 'j' && opts.jobs == 0) { // Number of files to assemble at once
+                i++;
+
+                if (i >= argc || (opts.jobs = (int) strtol(argv[i], nullptr, 10)) <= 0) {
+                    std::cout << "-j: expected a positive integer\n";
+                    return EXIT_FAILURE;
+                }
             } else if (argv[i][1] == 'p' && !opts.post_processing_file) { // Provide post-process output file
                 i++;
 
@@ -75,25 +134,82 @@ int parse_arguments(int argc, char **argv, Options &opts) {
                 opts.do_compilation = false;
             } else if (!opts.strict_sections && strcmp(argv[i] + 1, "-strict-sections") == 0) {
                 opts.strict_sections = true;
+            } else if (!opts.lib_cache && strcmp(argv[i] + 1, "-lib-cache") == 0) { // Cache pre-processed libraries
+                i++;
+
+                if (i >= argc) {
+                    std::cout << "--lib-cache: expected directory path\n";
+                    return EXIT_FAILURE;
+                }
+
+                opts.lib_cache = argv[i];
+            } else if (!opts.incremental && strcmp(argv[i] + 1, "-incremental") == 0) { // Re-use previous assemblies
+                i++;
+
+                if (i >= argc) {
+                    std::cout << "--incremental: expected directory path\n";
+                    return EXIT_FAILURE;
+                }
+
+                opts.incremental = argv[i];
+            } else if (!opts.serve && strcmp(argv[i] + 1, "-serve") == 0) { // Assemble requests from stdin
+                opts.serve = true;
+            } else if (opts.max_warnings == 0 && strcmp(argv[i] + 1, "-max-warnings") == 0) { // Limit printed warnings
+                i++;
+
+                if (i >= argc || (opts.max_warnings = (int) strtol(argv[i], nullptr, 10)) <= 0) {
+                    std::cout << "--max-warnings: expected a positive integer\n";
+                    return EXIT_FAILURE;
+                }
             } else {
                 std::cout << "Unknown/repeated flag " << argv[i] << "\n";
                 return EXIT_FAILURE;
             }
-        } else if (!opts.input_file) {
-            opts.input_file = argv[i];
         } else {
-            std::cout << "Unexpected argument '" << argv[i] << "'\n";
+            opts.input_files.push_back(argv[i]);
+        }
+    }
+
+    // Sources and options are given with each request
+    if (opts.serve) {
+        if (!opts.input_files.empty() || opts.output_file || opts.post_processing_file || opts.object_file) {
+            std::cout << "--serve: sources, -o, -p and -c are given per request\n";
             return EXIT_FAILURE;
         }
+
+        if (opts.symbols) {
+            std::cout << "-g: cannot be used with --serve\n";
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
     }
 
     // Check if all files are present
-    if (opts.input_file == nullptr) {
+    if (opts.input_files.empty()) {
         std::cout << "Expected input file to be provided\n";
         return EXIT_FAILURE;
     }
 
-    if (opts.output_file == nullptr && opts.do_compilation) {
+    if (opts.symbols && opts.object_file) {
+        std::cout << "-g: cannot be used with -c\n";
+        return EXIT_FAILURE;
+    }
+
+    // Only object files may be assembled in batches
+    if (opts.input_files.size() > 1) {
+        if (!opts.object_file) {
+            std::cout << "Unexpected argument '" << opts.input_files[1] << "'\n";
+            return EXIT_FAILURE;
+        }
+
+        if (opts.output_file || opts.post_processing_file) {
+            std::cout << (opts.output_file ? "-o" : "-p") << ": cannot be used with multiple input files\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (opts.output_file == nullptr && opts.do_compilation && !opts.object_file) {
         std::cout << "Expected output file to be provided (-o <file>)\n";
         return EXIT_FAILURE;
     }
@@ -169,61 +285,138 @@ int parse_data(assembler::Data &data, message::List& messages) {
         return EXIT_FAILURE;
     }
 
+    if (data.optimise) {
+        int saved = assembler::optimiser::optimise(data);
+
+        if (data.debug)
+            print_line("Optimiser saved " + std::to_string(saved) + " bytes");
+
+        // Labels have moved
+        data.evaluate_expressions(messages);
+
+        if (handle_messages(messages))
+            return EXIT_FAILURE;
+    }
+
     if (data.debug) {
         // Print chunks
         std::cout << "--- Chunks ---\n";
 
         for (const auto& chunk : data.chunks) {
-            chunk->print();
+            chunk.print(data.data_bytes);
         }
     }
 
     return EXIT_SUCCESS;
 }
 
-/** Compile data to given file. */
-int compile_result(assembler::Data& data, char *output_file) {
+/** Get contents of the output file: the binary image, or an object file. */
+std::vector<unsigned char> get_output(assembler::Data& data) {
+    if (!data.object_file) {
+        // Lay out compiled chunks in memory
+        return data.get_image();
+    }
+
+    std::stringstream stream;
+    assembler::object::write(data.get_object(), stream);
+    std::string bytes = stream.str();
+
+    return { bytes.begin(), bytes.end() };
+}
+
+/** Remove debug symbols left beside the given output file by an earlier `-g`, as they no longer describe it. */
+void remove_symbols(const char *output_file) {
+    std::error_code error;
+    std::filesystem::remove(assembler::symbols::get_path(output_file), error);
+}
+
+/** Compile data to given file. If <symbols>, write debug symbols beside it. */
+int compile_result(assembler::Data& data, const char *output_file, bool symbols) {
     // Open output file
     std::ofstream file(output_file, std::ios::binary);
 
     // Check if the file exists
     if (!file.good()) {
-        std::cout << "Failed to open output file " << output_file << "\n";
+        print_line("Failed to open output file " + std::string(output_file));
         return EXIT_FAILURE;
     }
 
-    // Write compiled chunks to output file
-    auto before = file.tellp();
-    data.write_headers(file);
-    data.write_chunks(file);
-    auto after = file.tellp();
+    // Write to output file in one go
+    auto output = get_output(data);
+    file.write((char *) output.data(), (std::streamsize) output.size());
 
     if (data.debug)
-        std::cout << "Written " << (after - before + 1) << " bytes to file " << output_file << "\n";
+        print_line("Written " + std::to_string(output.size()) + " bytes to file " + output_file);
 
     file.close();
 
-    return EXIT_SUCCESS;
-}
+    if (!symbols) {
+        remove_symbols(output_file);
+        return EXIT_SUCCESS;
+    }
 
-int main(int argc, char **argv) {
-    // Parse CLI
-    Options opts;
+    // Write debug symbols beside the binary
+    auto path = assembler::symbols::get_path(output_file);
+    auto table = data.get_symbols();
+    table.set_binary((const char *) output.data(), output.size());
 
-    if (parse_arguments(argc, argv, opts) == EXIT_FAILURE) {
+    if (!assembler::symbols::write(table, path)) {
+        print_line("Failed to open output file " + path.string());
         return EXIT_FAILURE;
     }
 
+    if (data.debug)
+        print_line("Written debug symbols to file " + path.string());
+
+    return EXIT_SUCCESS;
+}
+
+/** Assemble the given source file into <output_file>. */
+int assemble(const Options &opts, const char *executable, const char *input_file, const char *output_file) {
     // Set-up pre-processing data
     assembler::pre_processor::Data pre_data(opts.debug);
-    pre_data.set_executable(argv[0]);
+    pre_data.set_executable(executable);
+
+    if (opts.lib_cache)
+        pre_data.include_cache = opts.lib_cache;
+
     message::List messages;
+    messages.set_warning_limit(opts.max_warnings);
+
+    // Has anything changed since this file was last assembled?
+    std::filesystem::path cache_file;
+    assembler::incremental::Entry cache;
+    bool incremental = opts.incremental && opts.do_pre_processing && opts.do_compilation && !opts.post_processing_file &&
+                       !opts.symbols;
+
+    if (incremental) {
+        std::string options = std::string(opts.strict_sections ? "s" : "") + (opts.object_file ? "c" : "") + (opts.optimise ? "O" : "") +
+                              pre_data.get_lib_directory().string();
+        cache_file = assembler::incremental::get_cache_path(opts.incremental, input_file, options);
+
+        if (!assembler::incremental::load(cache_file, cache)) {
+            cache = {};
+        } else if (assembler::incremental::is_up_to_date(cache)) {
+            std::ofstream file(output_file, std::ios::binary);
+            file.write((char *) cache.output.data(), (std::streamsize) cache.output.size());
+
+            if (file.good()) {
+                remove_symbols(output_file);
+
+                if (opts.debug)
+                    print_line("Source file '" + std::string(input_file) + "' is unchanged, written " +
+                               std::to_string(cache.output.size()) + " bytes to file " + output_file);
+
+                return EXIT_SUCCESS;
+            }
+        }
+    }
 
     // Read source file into lines
     if (opts.debug)
-        std::cout << "Reading source file '" << opts.input_file << "'\n";
+        print_line("Reading source file '" + std::string(input_file) + "'");
 
-    assembler::read_source_file(opts.input_file, pre_data, messages);
+    assembler::read_source_file(input_file, pre_data, messages);
 
     // Check if error
     if (handle_messages(messages))
@@ -234,18 +427,160 @@ int main(int argc, char **argv) {
         return EXIT_FAILURE;
     }
 
+    // Every file whose change would change the output
+    std::vector<std::filesystem::path> dependencies;
+
+    if (incremental) {
+        std::error_code error;
+        dependencies.push_back(std::filesystem::weakly_canonical(input_file, error));
+        dependencies.insert(dependencies.end(), pre_data.dependencies.begin(), pre_data.dependencies.end());
+    }
+
     // Construct data structure for parsing
-    assembler::Data data(pre_data);
+    assembler::Data data(std::move(pre_data));
     data.strict_sections = opts.strict_sections;
+    data.object_file = opts.object_file;
+    data.optimise = opts.optimise;
+
+    if (incremental)
+        assembler::incremental::restore(cache, data);
 
     if (parse_data(data, messages) == EXIT_FAILURE) {
         return EXIT_FAILURE;
     }
 
     // Compile data
-    if (opts.do_compilation && compile_result(data, opts.output_file) == EXIT_FAILURE) {
+    if (opts.do_compilation && compile_result(data, output_file, opts.symbols) == EXIT_FAILURE) {
         return EXIT_FAILURE;
     }
 
+    if (incremental)
+        assembler::incremental::store(cache_file, dependencies, data, output_file);
+
+    return EXIT_SUCCESS;
+}
+
+/** Flags of a --serve request. */
+enum ServeFlags {
+    ServeStrictSections = 1, // --strict-sections
+    ServeObjectFile = 2, // -c
+    ServeOptimise = 4, // -O
+};
+
+/** Serve assembly requests on stdin until it is closed. Each is answered on stdout.
+ * Request: `<flags: u32> <path length: u32> <path> <source length: u32> <source>`. The path is used to resolve includes,
+ * and in messages.
+ * Reply: `<status: u8> <messages length: u32> <messages> <output length: u32> <output>`. The status is 0 on success, when
+ * the output is the binary image (or object file, with ServeObjectFile).
+ * Integers are in host byte order. */
+int serve(const Options &opts, const char *executable) {
+    using namespace assembler::binary_io;
+
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    // Everything the pipeline prints is a message for the client, so stdout is reserved for replies
+    std::ostream replies(std::cout.rdbuf());
+    std::stringstream printed;
+    std::cout.rdbuf(printed.rdbuf());
+
+    // Libraries stay pre-processed between requests
+    assembler::pre_processor::include_cache::keep_in_memory();
+
+    uint32_t flags;
+    std::string path, source;
+
+    while (read_int(std::cin, flags) && read_string(std::cin, path) && read_string(std::cin, source)) {
+        Options request = opts;
+        request.strict_sections = opts.strict_sections || (flags & ServeStrictSections);
+        request.object_file = flags & ServeObjectFile;
+        request.optimise = opts.optimise || (flags & ServeOptimise);
+
+        assembler::pre_processor::Data pre_data(request.debug);
+        pre_data.set_executable(executable);
+
+        if (request.lib_cache)
+            pre_data.include_cache = request.lib_cache;
+
+        message::List messages;
+        messages.set_warning_limit(request.max_warnings);
+
+        assembler::read_source(path.empty() ? "stdin" : path, source, pre_data);
+
+        // Pre-process, parse and compile
+        std::vector<unsigned char> output;
+        bool success = pre_process_data(pre_data, messages, nullptr) == EXIT_SUCCESS;
+
+        if (success) {
+            assembler::Data data(std::move(pre_data));
+            data.strict_sections = request.strict_sections;
+            data.object_file = request.object_file;
+            data.optimise = request.optimise;
+
+            if ((success = parse_data(data, messages) == EXIT_SUCCESS))
+                output = get_output(data);
+        }
+
+        write_int<uint8_t>(replies, success ? 0 : 1);
+        write_string(replies, printed.str());
+        write_int<uint32_t>(replies, output.size());
+        replies.write((const char *) output.data(), (std::streamsize) output.size());
+        replies.flush();
+
+        printed.str("");
+    }
+
     return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    // Parse CLI
+    Options opts;
+
+    if (parse_arguments(argc, argv, opts) == EXIT_FAILURE) {
+        return EXIT_FAILURE;
+    }
+
+    if (opts.serve) {
+        return serve(opts, argv[0]);
+    }
+
+    // Object files default to being placed beside their source
+    std::vector<std::string> output_files;
+
+    for (auto input_file : opts.input_files) {
+        output_files.push_back(opts.output_file ? opts.output_file
+                                                : std::filesystem::path(input_file).replace_extension(".o").string());
+    }
+
+    if (opts.input_files.size() == 1) {
+        return assemble(opts, argv[0], opts.input_files[0], output_files[0].c_str());
+    }
+
+    // Assemble files in parallel (debug output would be interleaved, so not in debug mode)
+    int jobs = opts.debug ? 1 : opts.jobs ? opts.jobs : (int) std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min(jobs, (int) opts.input_files.size());
+
+    std::atomic<size_t> next_file(0);
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> workers;
+
+    for (int i = 0; i < jobs; i++) {
+        workers.emplace_back([&]() {
+            size_t file;
+
+            while ((file = next_file++) < opts.input_files.size()) {
+                if (assemble(opts, argv[0], opts.input_files[file], output_files[file].c_str()) == EXIT_FAILURE)
+                    failed = true;
+            }
+        });
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
 }
\ No newline at end of file
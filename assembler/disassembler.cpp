@@ -13,6 +13,8 @@ struct Options {
     bool format_data;
     bool no_labels;
     bool no_commas;
+    bool no_symbols;
+    bool recursive;
 
     Options() {
         input_file = nullptr;
@@ -21,6 +23,8 @@ struct Options {
         format_data = false;
         no_labels = false;
         no_commas = false;
+        no_symbols = false;
+        recursive = false;
     }
 };
 
@@ -30,7 +34,7 @@ bool handle_messages(message::List& list) {
         msg.print();
     });
 
-    bool is_error = list.has_message_of(message::Level::Error);
+    bool is_error = list.has_errors();
 
     list.clear();
 
@@ -58,6 +62,10 @@ int parse_arguments(int argc, char **argv, Options &opts) {
                 opts.no_labels = true;
             } else if (!opts.no_commas && strcmp(argv[i] + 1, "-no-commas") == 0) {
                 opts.no_commas = true;
+            } else if (!opts.no_symbols && strcmp(argv[i] + 1, "-no-symbols") == 0) {
+                opts.no_symbols = true;
+            } else if (!opts.recursive && strcmp(argv[i] + 1, "-recursive") == 0) {
+                opts.recursive = true;
             } else {
                 std::cout << "Unknown/repeated flag " << argv[i] << "\n";
                 return EXIT_FAILURE;
@@ -97,7 +105,7 @@ int write_result(disassembler::Data& data, char *output_file) {
 
     // Write compiled chunks to output file
     auto before = file.tellp();
-    file << data.assembly.str();
+    file.write(data.assembly.data(), (std::streamsize) data.assembly.size());
     auto after = file.tellp();
 
     if (data.debug)
@@ -124,6 +132,7 @@ int main(int argc, char **argv) {
     data.format_data = opts.format_data;
     data.insert_labels = !opts.no_labels;
     data.insert_commas = !opts.no_commas;
+    data.recursive = opts.recursive;
 
     if (data.load_binary_file(opts.input_file)) {
         if (opts.debug)
@@ -137,6 +146,23 @@ int main(int argc, char **argv) {
         return EXIT_FAILURE;
     }
 
+    // Read debug symbols, if the binary has them
+    if (!opts.no_symbols) {
+        auto sym_file = assembler::symbols::get_path(opts.input_file);
+
+        if (std::filesystem::exists(sym_file)) {
+            if (!data.load_symbol_file(sym_file)) {
+                std::cout << "Warning: ignoring symbol file " << sym_file.string() << ", as it cannot be read\n";
+                data.symbols = {};
+            } else if (!data.symbols.describes(data.file_buffer, data.file_buffer_size)) {
+                std::cout << "Warning: ignoring symbol file " << sym_file.string() << ", as the binary has changed since it was written\n";
+                data.symbols = {};
+            } else if (opts.debug) {
+                std::cout << "Read " << data.symbols.symbols.size() << " symbols from " << sym_file.string() << "\n";
+            }
+        }
+    }
+
     // Disassemble
     if (opts.debug)
         std::cout << "Disassembling binary...\n";
@@ -87,3 +87,31 @@
     mov '\n', r1
     syscall
 %end
+
+%macro memcpy dest src len
+    mov dest, r1
+    mov src, r2
+    mov len, r3
+    mcpy r1, r2, r3
+%end
+
+%macro memset dest value len
+    mov dest, r1
+    mov value, r2
+    mov len, r3
+    mset r1, r2, r3
+%end
+
+%macro memcmp buf1 buf2 len
+    mov buf1, r1
+    mov buf2, r2
+    mov len, r3
+    mcmp r1, r2, r3
+%end
+
+%macro memchr buf value len
+    mov buf, r1
+    mov value, r2
+    mov len, r3
+    mchr r1, r2, r3
+%end
@@ -0,0 +1,198 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <unordered_map>
+
+#include "src/object_file.hpp"
+#include "src/messages/list.hpp"
+#include "src/messages/error.hpp"
+extern "C" {
+#include "util.h"
+}
+
+/** Label which execution starts at. */
+const std::string main_label = "main";
+
+struct Options {
+    std::vector<char *> input_files;
+    char *output_file;
+    bool debug;
+
+    Options() {
+        output_file = nullptr;
+        debug = false;
+    }
+};
+
+/** Handle message list: print messages and empty the list, return if there was an error. */
+bool handle_messages(message::List& list) {
+    list.for_each_message([] (message::Message &msg) {
+        msg.print();
+    });
+
+    bool is_error = list.has_errors();
+
+    list.clear();
+
+    return is_error;
+}
+
+/** Parse command-line arguments. */
+int parse_arguments(int argc, char **argv, Options &opts) {
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '-') {
+            if (argv[i][1] == 'd' && !opts.debug) { // Enable debug mode
+                opts.debug = true;
+            } else if (argv[i][1] == 'o' && !opts.output_file) { // Provide output file
+                i++;
+
+                if (i == argc) {
+                    std::cout << "-o: expected file path\n";
+                    return EXIT_FAILURE;
+                }
+
+                opts.output_file = argv[i];
+            } else {
+                std::cout << "Unknown/repeated flag " << argv[i] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else {
+            opts.input_files.push_back(argv[i]);
+        }
+    }
+
+    // Check if all files are present
+    if (opts.input_files.empty()) {
+        std::cout << "Expected input file to be provided\n";
+        return EXIT_FAILURE;
+    }
+
+    if (opts.output_file == nullptr) {
+        std::cout << "Expected output file to be provided (-o <file>)\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/** Object file, as placed in the final image. */
+struct Placement {
+    std::filesystem::path file;
+    assembler::object::Object object;
+    uint64_t base; // Offset of the object's image in the final image
+};
+
+/** Add <value> to the <size>-byte little-endian integer at <location>. */
+void add_to_value(unsigned char *location, uint8_t size, uint64_t value) {
+    uint64_t current = 0;
+    std::memcpy(&current, location, size);
+    current += value;
+    std::memcpy(location, &current, size);
+}
+
+int main(int argc, char **argv) {
+    // Parse CLI
+    Options opts;
+
+    if (parse_arguments(argc, argv, opts) == EXIT_FAILURE) {
+        return EXIT_FAILURE;
+    }
+
+    message::List messages;
+
+    // Read objects, placing each after the last at a multiple of its alignment
+    std::vector<Placement> placements;
+    uint64_t image_size = 0;
+
+    for (auto input_file : opts.input_files) {
+        Placement placement{ input_file, {}, 0 };
+
+        if (!assembler::object::read(input_file, placement.object)) {
+            std::cout << "Failed to read object file " << input_file << "\n";
+            return EXIT_FAILURE;
+        }
+
+        uint64_t align = placement.object.align;
+        image_size = (image_size + align - 1) / align * align;
+        placement.base = image_size;
+
+        if (opts.debug)
+            std::cout << "Placing '" << input_file << "' at offset " << image_size << " ("
+                      << placement.object.image.size() << " bytes)\n";
+
+        image_size += placement.object.image.size();
+        placements.push_back(std::move(placement));
+    }
+
+    // Collect every exported label
+    std::unordered_map<std::string, std::pair<uint64_t, const Placement *>> symbols;
+
+    for (const auto &placement : placements) {
+        for (const auto &symbol : placement.object.symbols) {
+            auto [existing, inserted] = symbols.insert({ symbol.name, { placement.base + symbol.offset, &placement } });
+
+            if (!inserted) {
+                auto err = new class message::Error(placement.file, -1, (int) symbol.offset, message::ErrorType::InvalidLabel);
+                err->set_message("Label '" + symbol.name + "' is already declared in " +
+                                 existing->second.second->file.string());
+                messages.add(err);
+            }
+        }
+    }
+
+    if (handle_messages(messages))
+        return EXIT_FAILURE;
+
+    // Concatenate images, then patch each reference with its final address
+    std::vector<unsigned char> image(sizeof(WORD_T) + image_size);
+    unsigned char *buffer = image.data() + sizeof(WORD_T);
+
+    for (const auto &placement : placements) {
+        const auto &object = placement.object;
+
+        if (!object.image.empty())
+            std::memcpy(buffer + placement.base, object.image.data(), object.image.size());
+
+        for (const auto &relocation : object.relocations) {
+            uint64_t address = placement.base;
+
+            if (!relocation.symbol.empty()) {
+                auto symbol = symbols.find(relocation.symbol);
+
+                if (symbol == symbols.end()) {
+                    auto err = new class message::Error(placement.file, -1, (int) relocation.offset, message::ErrorType::UnknownLabel);
+                    err->set_message("Reference to undefined label '" + relocation.symbol + "'");
+                    messages.add(err);
+                    continue;
+                }
+
+                address = symbol->second.first;
+            }
+
+            add_to_value(buffer + placement.base + relocation.offset, relocation.size, address);
+        }
+    }
+
+    if (handle_messages(messages))
+        return EXIT_FAILURE;
+
+    // Write start address
+    auto start_label = symbols.find(main_label);
+    WORD_T start_addr = start_label == symbols.end() ? 0 : (WORD_T) start_label->second.first;
+    std::memcpy(image.data(), &start_addr, sizeof(start_addr));
+
+    std::ofstream file(opts.output_file, std::ios::binary);
+
+    if (!file.good()) {
+        std::cout << "Failed to open output file " << opts.output_file << "\n";
+        return EXIT_FAILURE;
+    }
+
+    file.write((char *) image.data(), (std::streamsize) image.size());
+
+    if (opts.debug)
+        std::cout << "Written " << image.size() << " bytes to file " << opts.output_file << "\n";
+
+    return EXIT_SUCCESS;
+}
@@ -1,42 +1,237 @@
 #include "assembler_data.hpp"
+#include "messages/error.hpp"
+
+#include <algorithm>
+#include <cstring>
 extern "C" {
 #include "util.h"
 }
 
 namespace assembler {
-    void Data::replace_label(const std::string &label, int address) {
-        for (const auto &chunk : chunks) {
-            if (!chunk->is_data()) {
-                for (auto &arg : chunk->get_instruction()->args) {
-                    if (arg.is_label() && *arg.get_label() == label) {
-                        arg.transform_label(address);
-                    }
+    void Data::add_label_fixups(int chunk_index) {
+        auto &chunk = chunks[chunk_index];
+        auto instruction = chunk.get_instruction();
+        int arg_offset = chunk.get_offset() + (int) sizeof(OPCODE_T);
+
+        for (int i = 0; i < instruction->arg_count; i++) {
+            auto &arg = instruction->args[i];
+            int size = instruction->signature->get_param(i)->size;
+
+            if (arg.is_label()) {
+                if (records_relocations())
+                    relocations.push_back({ arg_offset, size, arg.get_label() });
+
+                auto label = labels.find(*arg.get_label());
+
+                if (label == labels.end()) {
+                    label_fixups[arg.get_label()].push_back({ chunk_index, i });
+                } else {
+                    arg.transform_label(label->second.addr);
                 }
             }
+
+            arg_offset += size;
         }
     }
 
+    void Data::replace_label(const std::string &label, int address) {
+        auto name = label_names.find(label);
+
+        if (name == label_names.end())
+            return;
+
+        auto fixups = label_fixups.find(&*name);
+
+        if (fixups == label_fixups.end())
+            return;
+
+        for (const auto &fixup : fixups->second) {
+            chunks[fixup.chunk].get_instruction()->args[fixup.arg].transform_label(address);
+        }
+
+        label_fixups.erase(fixups);
+    }
+
+    bool Data::evaluate_expressions(message::List &msgs) {
+        expression::Context context;
+        context.relocatable = object_file;
+
+        context.get_label = [this](const std::string &name, long long &address) {
+            auto label = labels.find(name);
+
+            if (label == labels.end())
+                return false;
+
+            address = label->second.addr;
+            return true;
+        };
+
+        context.get_size = [this](const std::string &name) -> long long {
+            long long address = labels.find(name)->second.addr;
+            auto chunk = std::lower_bound(chunks.begin(), chunks.end(), address, [](const Chunk &chunk, long long address) {
+                return chunk.get_offset() < address;
+            });
+
+            return chunk != chunks.end() && chunk->get_offset() == address ? chunk->get_bytes() : 0;
+        };
+
+        for (auto &pending : expressions) {
+            auto &chunk = chunks[pending.chunk];
+            std::string error;
+            context.here = chunk.get_offset();
+
+            if (!expression::evaluate(pending.expression, context, pending.value, error)) {
+                auto err = new class message::Error(file_path, lines[chunk.get_source_line()].n, pending.col,
+                                                    message::ErrorType::BadExpression);
+                err->set_message(error);
+                msgs.add(err);
+                continue;
+            }
+
+            auto value = (unsigned long long) pending.value.value;
+
+            if (!chunk.is_data()) {
+                auto &arg = chunk.get_instruction()->args[pending.position];
+                arg.update(arg.get_type(), value);
+                continue;
+            }
+
+            auto bytes = data_bytes.data() + chunk.get_data_start() + pending.position;
+
+            if (pending.is_float && pending.size == sizeof(float)) {
+                auto f32 = (float) pending.value.value;
+                std::memcpy(bytes, &f32, sizeof(f32));
+            } else if (pending.is_float) {
+                auto f64 = (double) pending.value.value;
+                std::memcpy(bytes, &f64, sizeof(f64));
+            } else {
+                std::memcpy(bytes, &value, pending.size);
+            }
+        }
+
+        return !msgs.has_errors();
+    }
+
+    int Data::get_expression_offset(const PendingExpression &expression) {
+        auto &chunk = chunks[expression.chunk];
+        int offset = chunk.get_offset() + expression.position;
+
+        if (!chunk.is_data()) {
+            auto signature = chunk.get_instruction()->signature;
+            offset = chunk.get_offset() + (int) sizeof(OPCODE_T);
+
+            for (int i = 0; i < expression.position; i++)
+                offset += signature->get_param(i)->size;
+        }
+
+        return offset;
+    }
+
     int Data::get_bytes() {
         if (chunks.empty())
             return 0;
 
-        auto last = chunks.back();
-        return last->get_offset() + last->get_bytes();
+        auto &last = chunks.back();
+        return last.get_offset() + last.get_bytes();
     }
 
-    void Data::write_headers(std::ostream &stream) {
+    int Data::get_header_bytes() {
+        return chunks.empty() ? 0 : (int) sizeof(WORD_T);
+    }
+
+    unsigned char *Data::write_headers(unsigned char *buffer) {
         if (chunks.empty())
-            return;
+            return buffer;
 
         // Write start address
         auto start_label = labels.find(main_label);
         WORD_T start_addr = start_label == labels.end() ? (section_text == -1 ? 0 : section_text) : start_label->second.addr;
-        stream.write((char *) &start_addr, sizeof(start_addr));
+        std::memcpy(buffer, &start_addr, sizeof(start_addr));
+
+        return buffer + sizeof(start_addr);
+    }
+
+    void Data::write_chunks(unsigned char *buffer) {
+        for (const auto &chunk : chunks) {
+            chunk.write(buffer + chunk.get_offset(), data_bytes);
+        }
+    }
+
+    object::Object Data::get_object() {
+        object::Object object;
+
+        // Undeclared labels are external, so leave a zero for the linker to add to
+        for (const auto &[label, fixups] : label_fixups) {
+            for (const auto &fixup : fixups) {
+                chunks[fixup.chunk].get_instruction()->args[fixup.arg].transform_label(0);
+            }
+        }
+
+        object.image.resize(get_bytes());
+
+        if (!object.image.empty())
+            write_chunks(object.image.data());
+
+        for (const auto &chunk : chunks) {
+            object.align = std::max(object.align, (uint32_t) chunk.get_align());
+        }
+
+        for (const auto &[name, label] : labels) {
+            object.symbols.push_back({ name, (uint64_t) label.addr });
+        }
+
+        // Keep object files reproducible
+        std::sort(object.symbols.begin(), object.symbols.end(), [](const auto &a, const auto &b) {
+            return a.offset == b.offset ? a.name < b.name : a.offset < b.offset;
+        });
+
+        for (const auto &relocation : relocations) {
+            bool is_external = relocation.label && labels.find(*relocation.label) == labels.end();
+            object.relocations.push_back({ (uint64_t) relocation.offset, (uint8_t) relocation.size,
+                                           is_external ? *relocation.label : "" });
+        }
+
+        for (const auto &expression : expressions) {
+            if (expression.value.addresses == 0 && !expression.value.external)
+                continue;
+
+            auto &chunk = chunks[expression.chunk];
+            int size = chunk.is_data() ? expression.size : chunk.get_instruction()->signature->get_param(expression.position)->size;
+            object.relocations.push_back({ (uint64_t) get_expression_offset(expression), (uint8_t) size,
+                                           expression.value.external ? *expression.value.external : "" });
+        }
+
+        return object;
     }
 
-    void Data::write_chunks(std::ostream& stream) {
-        for (auto chunk : chunks) {
-            chunk->write(stream);
+    symbols::Table Data::get_symbols() {
+        symbols::Table table;
+
+        for (const auto &[name, label] : labels) {
+            table.symbols.push_back({ name, (uint64_t) label.addr });
         }
+
+        std::sort(table.symbols.begin(), table.symbols.end(), [](const auto &a, const auto &b) {
+            return a.address == b.address ? a.name < b.name : a.address < b.address;
+        });
+
+        // Consecutive chunks from the same line share an entry
+        for (const auto &chunk : chunks) {
+            int line = lines[chunk.get_source_line()].n + 1;
+
+            if (table.lines.empty() || table.lines.back().line != line)
+                table.lines.push_back({ (uint64_t) chunk.get_offset(), line });
+        }
+
+        return table;
+    }
+
+    std::vector<unsigned char> Data::get_image() {
+        std::vector<unsigned char> image(get_image_bytes());
+
+        if (!image.empty())
+            write_chunks(write_headers(image.data()));
+
+        return image;
     }
 }
@@ -1,48 +1,112 @@
 #pragma once
 
 #include "chunk.hpp"
+#include "expression.hpp"
 #include "pre-process/data.hpp"
 #include "label.hpp"
+#include "messages/list.hpp"
+#include "object_file.hpp"
+#include "symbol_file.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
 
 namespace assembler {
+    /** Instruction parsed from the text of a line (from its mnemonic onwards), before any labels are resolved. */
+    struct CachedInstruction {
+        instruction::Instruction instruction;
+        bool used; // Was this text seen during this run?
+    };
+
+    /** An argument or data item given by an expression, which is evaluated once every label has been laid out. */
+    struct PendingExpression {
+        int chunk; // Index of chunk
+        int position; // Argument index if an instruction, else byte offset into the chunk's data
+        int size; // Byte-size of a data item
+        bool is_float; // Is a data item stored as a float?
+        int col; // Column of the source line
+        expression::Expression expression;
+        expression::Value value; // Result of the last evaluation
+    };
+
     struct Data {
         std::filesystem::path file_path;  // Name of source file
         bool debug;               // Print debug comments?
         bool strict_sections; // Mnemonics must line up with section type
+        bool object_file; // Assembling an object file? Undeclared labels are then left to the linker
+        bool optimise; // Run the peephole optimiser over the chunks once parsed?
         std::vector<Line> lines;  // List of source file lines
         std::map<std::string, Label> labels;
+        std::unordered_set<std::string> label_names; // Interned label names, referenced by label arguments
+        std::unordered_map<const std::string *, std::vector<LabelFixup>> label_fixups; // Forward references awaiting each label
         std::string main_label; // Contain "main" label name
-        std::vector<Chunk *> chunks; // List of compiled chunks
+        std::vector<Chunk> chunks; // List of compiled chunks
+        std::vector<unsigned char> data_bytes; // Arena holding the bytes of every data chunk
+        std::vector<Relocation> relocations; // Label references (if records_relocations())
+        std::vector<PendingExpression> expressions; // Arguments and data items given by expressions
+        bool incremental; // Reuse instructions from, and record them in, instruction_cache?
+        std::unordered_map<std::string, CachedInstruction> instruction_cache; // Parsed instructions, by their text
         int section_text;
 
         explicit Data(bool debug) {
             this->debug = debug;
             strict_sections = false;
+            object_file = false;
+            optimise = false;
+            incremental = false;
             main_label = "main";
             section_text = -1;
         }
 
-        explicit Data(pre_processor::Data &data) : Data(data.debug) {
+        /** Construct from pre-processed data, taking its lines. */
+        explicit Data(pre_processor::Data &&data) : Data(data.debug) {
             file_path = data.file_path;
-            lines = data.lines;
+            lines = std::move(data.lines);
         }
 
-        ~Data() {
-            for (auto chunk : chunks) {
-                delete chunk;
-            }
-        }
+        /** Are label references recorded in `relocations`? Both object files and the optimiser need to find them. */
+        [[nodiscard]] bool records_relocations() const { return object_file || optimise; }
+
+        /** Return the interned copy of the given label name. */
+        const std::string *intern_label(const std::string &label) { return &*label_names.insert(label).first; }
+
+        /** Resolve label references in the arguments of the chunk at the given index, or record them as fixups if the
+         * label is yet to be declared. */
+        void add_label_fixups(int chunk_index);
 
-        /** Replace all instances of <label> with the given <address>. */
+        /** Replace all pending references to <label> with the given <address>. */
         void replace_label(const std::string &label, int address);
 
+        /** Evaluate every expression, writing its value to its argument or data. Return whether this was successful. */
+        bool evaluate_expressions(message::List &msgs);
+
+        /** Get byte offset of the value of the given expression. */
+        int get_expression_offset(const PendingExpression &expression);
+
         /** Get size in bytes. */
         int get_bytes();
 
-        /** Write headers to stream. */
-        void write_headers(std::ostream& stream);
+        /** Get size in bytes of the headers. */
+        int get_header_bytes();
+
+        /** Get size in bytes of the binary image (headers + chunks). */
+        int get_image_bytes() { return get_header_bytes() + get_bytes(); }
+
+        /** Write headers to buffer, return pointer to after them. */
+        unsigned char *write_headers(unsigned char *buffer);
+
+        /** Write chunks to buffer. */
+        void write_chunks(unsigned char *buffer);
+
+        /** Lay out the binary image into memory. */
+        std::vector<unsigned char> get_image();
+
+        /** Build an object file: the chunks (without headers), every label, and relocations for label references.
+         * References to labels which were never declared are zeroed, to be filled in by the linker. Expressions which
+         * are addresses are relocated too. */
+        object::Object get_object();
 
-        /** Write chunks to output stream. */
-        void write_chunks(std::ostream& stream);
+        /** Build the debug symbols of the image: every label, and the source line of each chunk. */
+        symbols::Table get_symbols();
     };
 }
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+/** Helpers shared by the assembler's on-disk formats (object files and caches). Integers are written in host order. */
+namespace assembler::binary_io {
+    template<typename T>
+    inline void write_int(std::ostream &out, T value) {
+        out.write((const char *) &value, sizeof(value));
+    }
+
+    inline void write_string(std::ostream &out, const std::string &string) {
+        write_int<uint32_t>(out, string.size());
+        out.write(string.data(), (std::streamsize) string.size());
+    }
+
+    template<typename T>
+    inline bool read_int(std::istream &in, T &value) {
+        return (bool) in.read((char *) &value, sizeof(value));
+    }
+
+    inline bool read_string(std::istream &in, std::string &string) {
+        uint32_t size;
+
+        if (!read_int(in, size))
+            return false;
+
+        string.resize(size);
+        return (bool) in.read(string.data(), size);
+    }
+
+    /** Write the header of a format: its magic, then its version. */
+    inline void write_header(std::ostream &out, const char (&magic)[4], uint32_t version) {
+        out.write(magic, sizeof(magic));
+        write_int(out, version);
+    }
+
+    /** Read the header of a format. Return false unless it has the given magic and version. */
+    inline bool read_header(std::istream &in, const char (&magic)[4], uint32_t version) {
+        char header[sizeof(magic)];
+        uint32_t file_version;
+
+        if (!in.read(header, sizeof(header)) || !std::equal(header, header + sizeof(header), magic))
+            return false;
+
+        return read_int(in, file_version) && file_version == version;
+    }
+
+    /** Write an unsigned integer in as few bytes as possible: 7 bits per byte, least significant first, with the top bit
+     * set on every byte but the last. */
+    inline void write_varint(std::ostream &out, uint64_t value) {
+        while (value >= 0x80) {
+            out.put((char) (value | 0x80));
+            value >>= 7;
+        }
+
+        out.put((char) value);
+    }
+
+    inline bool read_varint(std::istream &in, uint64_t &value) {
+        value = 0;
+
+        for (int shift = 0; shift < 64; shift += 7) {
+            int byte = in.get();
+
+            if (byte == EOF)
+                return false;
+
+            value |= (uint64_t) (byte & 0x7F) << shift;
+
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    /** FNV-1a hash of the given bytes. */
+    inline uint64_t hash_bytes(const char *bytes, size_t length, uint64_t hash = 0xcbf29ce484222325) {
+        for (size_t i = 0; i < length; i++) {
+            hash ^= (unsigned char) bytes[i];
+            hash *= 0x100000001b3;
+        }
+
+        return hash;
+    }
+
+    /** Hash contents of the given file. Return false if it cannot be read. */
+    inline bool hash_file(const std::filesystem::path &path, uint64_t &hash) {
+        std::ifstream file(path, std::ios::binary);
+
+        if (!file.good())
+            return false;
+
+        std::stringstream stream;
+        stream << file.rdbuf();
+        std::string contents = stream.str();
+        hash = hash_bytes(contents.data(), contents.size());
+
+        return true;
+    }
+
+    /** Write a file via <write>, going through a temporary file so concurrent readers never see a partial file. Return
+     * whether this was successful. */
+    inline bool write_atomically(const std::filesystem::path &path, const std::function<void(std::ostream &)> &write) {
+        std::error_code error;
+        auto temp_path = path;
+        temp_path += "." + std::to_string(std::random_device()()) + ".tmp";
+
+        {
+            std::ofstream out(temp_path, std::ios::binary);
+
+            if (out.good())
+                write(out);
+
+            if (!out.good()) {
+                out.close();
+                std::filesystem::remove(temp_path, error);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temp_path, path, error);
+
+        if (error) {
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+
+        return true;
+    }
+}
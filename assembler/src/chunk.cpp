@@ -1,67 +1,34 @@
 #include "chunk.hpp"
 
+#include <cstring>
 #include <iomanip>
 
 namespace assembler {
-    void Chunk::free_ptr() const {
-        if (m_ptr != nullptr) {
-            if (m_is_data) {
-                delete get_data();
-            } else {
-                delete get_instruction();
-            }
-        }
-    }
-
-    Chunk::~Chunk() {
-        free_ptr();
-    }
-
-    void Chunk::print() const {
+    void Chunk::print(const std::vector<unsigned char> &arena) const {
         std::cout << "Chunk at +" << m_offset << " of " << m_bytes << " bytes";
 
         if (m_is_data) {
             std::cout << " - data:\n\t" << std::uppercase << std::hex;
 
-            auto bytes = *get_data();
-
-            for (int i = 0; i < bytes.size(); i++) {
-                std::cout << std::setw(2) << std::setfill('0') << (int) bytes[i];
+            for (int i = 0; i < m_bytes; i++) {
+                std::cout << std::setw(2) << std::setfill('0') << (int) arena[m_data_start + i];
 
-                if (i + 1 < bytes.size())
+                if (i + 1 < m_bytes)
                     std::cout << " ";
             }
 
             std::cout << std::dec << "\n";
         } else {
             std::cout << " - instruction:\n\t";
-            get_instruction()->print();
+            m_instruction.print();
         }
     }
 
-    void Chunk::set_instruction(instruction::Instruction *instruction) {
-        free_ptr();
-
-        m_is_data = false;
-        m_bytes = instruction->get_bytes();
-        m_ptr = instruction;
-    }
-
-    void Chunk::set_data(std::vector<unsigned char> *data) {
-        free_ptr();
-
-        m_is_data = true;
-        m_bytes = (int) data->size();
-        m_ptr = data;
-    }
-
-    void Chunk::write(std::ostream &out) const {
+    void Chunk::write(unsigned char *out, const std::vector<unsigned char> &arena) const {
         if (m_is_data) {
-            for (auto& byte : *get_data()) {
-                out.write((char *) &byte, sizeof(byte));
-            }
+            std::memcpy(out, arena.data() + m_data_start, m_bytes);
         } else {
-            get_instruction()->write(out);
+            m_instruction.write(out);
         }
     }
 }
@@ -2,52 +2,82 @@
 
 #include "instructions/instruction.hpp"
 
+#include <vector>
+
 namespace assembler {
+    /** A compiled chunk, stored by value. Data chunks refer to a range of bytes in the data arena (`Data::data_bytes`). */
     class Chunk {
     private:
         bool m_is_data; // Is data or an instruction?
         int m_offset;  // Byte offset
         int m_bytes;   // Byte length
-        void *m_ptr;  // Internal data, either std::string* or std::vector<unsigned char>*
         int m_source_line; // Index of source line
+        int m_align = 1; // Offset must be a multiple of this
+        int m_item_bytes = 1; // If m_is_data: byte-size of each item (its natural alignment)
+        bool m_read_only = false; // If m_is_data: is this in `.section rodata`, so never written to?
 
-        void free_ptr() const;
+        union {
+            instruction::Instruction m_instruction; // If !m_is_data
+            size_t m_data_start; // If m_is_data: index of first byte in the data arena
+        };
 
     public:
-        Chunk(int line_idx, int offset) {
+        /** Create an instruction chunk. */
+        Chunk(int line_idx, int offset, const instruction::Instruction &instruction) : m_instruction(instruction) {
             m_offset = offset;
             m_source_line = line_idx;
             m_is_data = false;
-            m_bytes = 0;
-            m_ptr = nullptr;
+            m_bytes = instruction.get_bytes();
         }
 
-        ~Chunk();
+        /** Create a data chunk of <bytes> bytes, starting at <data_start> in the data arena. */
+        Chunk(int line_idx, int offset, size_t data_start, int bytes) : m_data_start(data_start) {
+            m_offset = offset;
+            m_source_line = line_idx;
+            m_is_data = true;
+            m_bytes = bytes;
+        }
 
-        void print() const;
+        void print(const std::vector<unsigned char> &arena) const;
 
         /** Are we representing data? */
         [[nodiscard]] bool is_data() const { return m_is_data; }
 
         [[nodiscard]] int get_offset() const { return m_offset; }
 
+        void set_offset(int offset) { m_offset = offset; }
+
+        /** Encode our instruction with a different signature, taking the same arguments. */
+        void set_signature(instruction::Signature *signature) {
+            m_instruction.signature = signature;
+            m_bytes = m_instruction.get_bytes();
+        }
+
         [[nodiscard]] int get_bytes() const { return m_bytes; }
 
-        [[nodiscard]] int get_source_line() const { return m_source_line; }
+        [[nodiscard]] int get_align() const { return m_align; }
 
-        /** Interpret data as an instruction. */
-        [[nodiscard]] instruction::Instruction *get_instruction() const { return (instruction::Instruction *) m_ptr; }
+        void set_align(int align) { m_align = align; }
+
+        [[nodiscard]] int get_item_bytes() const { return m_item_bytes; }
+
+        void set_item_bytes(int bytes) { m_item_bytes = bytes; }
+
+        [[nodiscard]] bool is_read_only() const { return m_read_only; }
 
-        /** Set data as instruction. */
-        void set_instruction(instruction::Instruction *instruction);
+        void set_read_only(bool read_only) { m_read_only = read_only; }
 
-        /** Interpret data as data. */
-        [[nodiscard]] std::vector<unsigned char> *get_data() const { return (std::vector<unsigned char> *) m_ptr; }
+        [[nodiscard]] int get_source_line() const { return m_source_line; }
+
+        /** Interpret data as an instruction. */
+        [[nodiscard]] instruction::Instruction *get_instruction() { return &m_instruction; }
 
-        /** Set data as instruction. */
-        void set_data(std::vector<unsigned char> *data);
+        [[nodiscard]] const instruction::Instruction *get_instruction() const { return &m_instruction; }
 
-        void write(std::ostream& out) const;
+        /** Interpret data as data: get index of first byte in the data arena. */
+        [[nodiscard]] size_t get_data_start() const { return m_data_start; }
 
+        /** Write chunk's bytes to <out>, which must have room for get_bytes() bytes. */
+        void write(unsigned char *out, const std::vector<unsigned char> &arena) const;
     };
 }
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include "disassembler.hpp"
 #include "messages/error.hpp"
@@ -7,18 +9,43 @@ extern "C" {
 }
 
 namespace disassembler {
-    /** Disassembler given data. */
-    void disassemble(Data &data, message::List &msgs) {
-        if (data.debug)
-            std::cout << "Start address: +" << data.start_addr << "\n";
+    /** Get the ordinal of the label at the given offset, or -1 if there is none. */
+    static int find_label(const std::vector<std::pair<int, int>> &labels, int offset) {
+        auto label = std::lower_bound(labels.begin(), labels.end(), offset, [](const std::pair<int, int> &label, int offset) {
+            return label.first < offset;
+        });
+
+        return label != labels.end() && label->first == offset ? label->second : -1;
+    }
+
+    /** Sort labels by offset. Where an offset was labelled more than once, keep the first label. */
+    static void sort_labels(std::vector<std::pair<int, int>> &labels) {
+        std::stable_sort(labels.begin(), labels.end(), [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+            return a.first < b.first;
+        });
 
+        labels.erase(std::unique(labels.begin(), labels.end(), [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+            return a.first == b.first;
+        }), labels.end());
+    }
+
+    /** Split buffer into instructions and data by reading from the start: anything which is not a known opcode is data. */
+    static void sweep(Data &data) {
         // Track current position
         int pos = 0;
+        int size = (int) data.buffer_size;
+        int data_start = -1; // Start of the data being read, if any
+
+        while (pos < size) {
+            // Not enough space left for an opcode
+            if (pos + (int) sizeof(OPCODE_T) > size) {
+                if (data_start == -1)
+                    data_start = pos;
 
-        std::vector<unsigned char> data_bytes;
+                pos = size;
+                break;
+            }
 
-        // Initial pass: populate map data structures
-        while (pos < data.buffer_size) {
             // Read current byte as opcode
             OPCODE_T opcode = *(OPCODE_T *)(data.buffer + pos);
 
@@ -27,157 +54,289 @@ namespace disassembler {
 
             // Unknown opcode
             if (signature == nullptr) {
-                for (int off = 0; off < sizeof(opcode); ++off) {
-                    data_bytes.push_back((opcode >> (off * 8)) & 0xFF);
-                }
+                if (data_start == -1)
+                    data_start = pos;
 
                 pos += sizeof(opcode);
                 continue;
             }
 
             // Not enough space left for instruction
-            if (pos + signature->get_bytes() >= data.buffer_size) {
-                for (; pos < data.buffer_size; pos++) {
-                    data_bytes.push_back(data.buffer[pos]);
-                }
+            if (pos + signature->get_bytes() >= size) {
+                if (data_start == -1)
+                    data_start = pos;
 
+                pos = size;
                 break;
             }
 
             // Record data segment if necessary
-            if (!data_bytes.empty()) {
-                data.data_offsets.insert({ pos - data_bytes.size(), data_bytes });
-                data_bytes.clear();
+            if (data_start != -1) {
+                data.items.push_back({ data_start, pos - data_start, nullptr });
+                data_start = -1;
             }
 
             // Record instruction
-            data.instruction_offsets.insert({ pos, signature });
+            data.items.push_back({ pos, (int) signature->get_bytes(), signature });
             pos += signature->get_bytes();
         }
 
         // If more data in buffer, record it
-        if (!data_bytes.empty()) {
-            data.data_offsets.insert({ pos - data_bytes.size(), data_bytes });
-            data_bytes.clear();
+        if (data_start != -1)
+            data.items.push_back({ data_start, pos - data_start, nullptr });
+    }
+
+    /** Split buffer into instructions and data by following control flow from the start address: jump and call targets,
+     * and the instruction after any which may continue. Bytes which are never reached are data. */
+    static void trace(Data &data) {
+        int size = (int) data.buffer_size;
+        std::vector<bool> is_code(size, false);
+        std::vector<int> worklist = { data.start_addr };
+
+        while (!worklist.empty()) {
+            int pos = worklist.back();
+            worklist.pop_back();
+
+            // Decode instructions until one does not continue, or we reach code which has been seen
+            while (pos >= 0 && pos + (int) sizeof(OPCODE_T) <= size && !is_code[pos]) {
+                OPCODE_T opcode = *(OPCODE_T *)(data.buffer + pos);
+                auto signature = assembler::instruction::Signature::find(opcode);
+
+                if (signature == nullptr)
+                    break;
+
+                int bytes = signature->get_bytes();
+
+                // Instruction must fit, and not overlap another
+                if (pos + bytes > size || std::find(is_code.begin() + pos, is_code.begin() + pos + bytes, true) != is_code.begin() + pos + bytes)
+                    break;
+
+                std::fill(is_code.begin() + pos, is_code.begin() + pos + bytes, true);
+                data.items.push_back({ pos, bytes, signature });
+
+                // Queue jump or call target
+                if (assembler::instruction::is_jmp_opcode(opcode) || opcode == OP_CALL_LIT) {
+                    auto param = signature->get_param((int) signature->param_count() - 1);
+
+                    if (param->type == assembler::instruction::ParamType::Literal ||
+                        param->type == assembler::instruction::ParamType::Relative) {
+                        auto target = extract_number(data.buffer, param->size, pos + bytes - param->size,
+                                                     param->type == assembler::instruction::ParamType::Relative);
+
+                        if (param->type == assembler::instruction::ParamType::Relative)
+                            target += pos + bytes;
+
+                        worklist.push_back((int) target);
+                    }
+                }
+
+                pos += bytes;
+
+                if (assembler::instruction::is_terminator_opcode(opcode))
+                    break;
+            }
+        }
+
+        if (data.debug)
+            std::cout << "Reached " << data.items.size() << " instructions from +" << data.start_addr << "\n";
+
+        // Everything between instructions is data
+        std::sort(data.items.begin(), data.items.end(), [](const Item &a, const Item &b) {
+            return a.offset < b.offset;
+        });
+
+        std::vector<Item> items;
+        items.reserve(data.items.size() * 2 + 1);
+        int pos = 0;
+
+        for (const auto &item : data.items) {
+            if (item.offset > pos)
+                items.push_back({ pos, item.offset - pos, nullptr });
+
+            items.push_back(item);
+            pos = item.offset + item.size;
         }
 
+        if (pos < size)
+            items.push_back({ pos, size - pos, nullptr });
+
+        data.items = std::move(items);
+    }
+
+    /** Disassembler given data. */
+    void disassemble(Data &data, message::List &msgs) {
+        if (data.debug)
+            std::cout << "Start address: +" << data.start_addr << "\n";
+
+        // Initial pass: split buffer into instructions and data
+        data.items.clear();
+
+        if (data.recursive) {
+            trace(data);
+        } else {
+            sweep(data);
+        }
+
+        // Split data segments where a symbol or source line begins, so it is written in place
+        std::vector<int> splits;
+
+        if (data.insert_labels) {
+            for (const auto &symbol : data.symbols.symbols)
+                splits.push_back((int) symbol.address);
+        }
+
+        for (const auto &entry : data.symbols.lines)
+            splits.push_back((int) entry.address);
+
         // Check if any data segments are referenced inside opcodes for data labels
+        data.data_labels.clear();
+        data.pos_labels.clear();
+
         if (data.insert_labels) {
             int data_label_idx = 0;
             int pos_label_idx = 0;
 
-            for (auto &pair: data.instruction_offsets) {
-                pos = pair.first + (int) sizeof(pair.second->get_opcode());
+            for (const auto &item : data.items) {
+                if (item.signature == nullptr)
+                    continue;
+
+                int pos = item.offset + (int) sizeof(item.signature->get_opcode());
 
                 // Iterate over instruction arguments
-                for (int i = 0; i < pair.second->param_count(); i++) {
-                    auto param = pair.second->get_param(i);
+                for (int i = 0; i < item.signature->param_count(); i++) {
+                    auto param = item.signature->get_param(i);
                     bool is_lit_addr = param->type == assembler::instruction::ParamType::Literal ||
                                        param->type == assembler::instruction::ParamType::Address;
 
-                    // Check if we have a JMP instruction
-                    if (assembler::instruction::is_jmp_opcode(pair.second->get_opcode())) {
-                        if (is_lit_addr) {
+                    // Check if we have a JMP instruction's target
+                    if (assembler::instruction::is_jmp_opcode(item.signature->get_opcode()) && i == item.signature->param_count() - 1) {
+                        if (is_lit_addr || param->type == assembler::instruction::ParamType::Relative) {
                             // Extract location
-                            auto value = extract_number(data.buffer, param->size, pos);
+                            auto value = extract_number(data.buffer, param->size, pos, param->type == assembler::instruction::ParamType::Relative);
+
+                            if (param->type == assembler::instruction::ParamType::Relative)
+                                value += item.offset + item.size;
 
-                            data.pos_labels.insert({value, pos_label_idx++});
+                            data.pos_labels.emplace_back((int) value, pos_label_idx++);
+                            splits.push_back((int) value);
                         }
                     } else if (is_lit_addr) {
                         // Extract location
-                        int value = (int) extract_number(data.buffer, param->size, pos);
+                        int value = (int) extract_number(data.buffer, param->size, pos, false);
 
-                        // Is there a data segment at this location?
-                        auto segment = data.get_segment_in(value);
-
-                        if (segment) {
+                        // Is there a data segment at this location? If so, split it here
+                        if (data.is_data(value)) {
                             if (data.debug)
                                 std::cout << "[+" << pos << "] Found literal/address pointing to data segment at +"
                                           << value << "\n";
 
-                            data.data_labels.insert({value, data_label_idx++});
-
-                            // Do we need to split the segment?
-                            if (value != segment->first) {
-                                // Split segment into two
-                                int split_at = value - segment->first;
-                                std::vector<unsigned char> former_segment(segment->second.begin(), segment->second.begin() + split_at),
-                                    latter_segment(segment->second.begin() + split_at, segment->second.end());
-
-                                data.data_offsets[segment->first] = former_segment;
-                                data.data_offsets.insert({value, latter_segment});
-                            }
+                            data.data_labels.emplace_back(value, data_label_idx++);
+                            splits.push_back(value);
                         }
                     }
 
                     pos += param->size;
                 }
             }
+
+            sort_labels(data.data_labels);
+            sort_labels(data.pos_labels);
         }
 
+        data.split_data(std::move(splits));
+
+        // A label can only be written where an instruction or data begins, or at the end
+        data.pos_labels.erase(std::remove_if(data.pos_labels.begin(), data.pos_labels.end(), [&data](const std::pair<int, int> &label) {
+            return label.first != (int) data.buffer_size && !data.is_item(label.first);
+        }), data.pos_labels.end());
+
         // Write assembly source
-        pos = 0;
+        data.assembly.clear();
+        data.assembly.reserve(data.buffer_size * 4 + 64);
 
-        while (pos <= data.buffer_size) {
-            // Main label?
-            if (pos > 0 && pos == data.start_addr) {
-                data.assembly << data.main_label << ":\n";
-            }
+        const auto &lines = data.symbols.lines;
+        const auto &symbols = data.symbols.symbols;
+        size_t line_idx = 0, symbol_idx = 0, pos_label_idx = 0;
 
-            // Position label?
-            auto pos_label = data.pos_labels.find(pos);
+        // Write everything which precedes the item at the given offset
+        auto write_labels = [&](int offset) {
+            // Source line?
+            while (line_idx < lines.size() && lines[line_idx].address < (uint64_t) offset)
+                line_idx++;
 
-            if (pos_label != data.pos_labels.end()) {
-                data.assembly << data.get_pos_label(pos_label->second) << ":\n";
+            if (line_idx < lines.size() && lines[line_idx].address == (uint64_t) offset) {
+                data.assembly += "; line " + std::to_string(lines[line_idx].line) + "\n";
             }
 
-            auto found_data = data.data_offsets.find(pos);
+            // Symbols? These replace any generated label
+            bool has_symbol = false;
 
-            // We have a data segment
-            if (found_data != data.data_offsets.end()) {
-                write_data_segment(data, pos);
-                continue;
+            if (data.insert_labels) {
+                for (; symbol_idx < symbols.size() && symbols[symbol_idx].address <= (uint64_t) offset; symbol_idx++) {
+                    if (symbols[symbol_idx].address == (uint64_t) offset) {
+                        data.assembly += symbols[symbol_idx].name + ":\n";
+                        has_symbol = true;
+                    }
+                }
             }
 
-            auto found_op = data.instruction_offsets.find(pos);
+            // Main label?
+            if (!has_symbol && offset > 0 && offset == data.start_addr) {
+                data.assembly += data.main_label + ":\n";
+            }
 
-            // We have an instruction segment
-            if (found_op != data.instruction_offsets.end()) {
-                write_signature_to_stream(data, *found_op->second, pos);
-                continue;
+            // Position label?
+            while (pos_label_idx < data.pos_labels.size() && data.pos_labels[pos_label_idx].first < offset)
+                pos_label_idx++;
+
+            if (!has_symbol && pos_label_idx < data.pos_labels.size() && data.pos_labels[pos_label_idx].first == offset) {
+                data.assembly += data.get_pos_label(data.pos_labels[pos_label_idx].second) + ":\n";
             }
+        };
 
-            pos++;
-        }
-    }
+        for (const auto &item : data.items) {
+            write_labels(item.offset);
 
-    void write_data_segment(Data &data, int &offset) {
-        // Find segment at offset
-        auto segment = data.data_offsets.find(offset);
+            if (item.signature == nullptr) {
+                write_data_segment(data, item);
+            } else {
+                write_signature(data, item);
+            }
+        }
 
-        if (segment == data.data_offsets.end())
-            return;
+        write_labels((int) data.buffer_size);
+    }
 
-        // Predicated by a label?
-        auto label_num = data.data_labels.find(offset);
+    void write_data_segment(Data &data, const Item &item) {
+        // Predicated by a label? Symbols have already been written
+        int label_num = find_label(data.data_labels, item.offset);
 
-        if (label_num != data.data_labels.end()) {
-            data.assembly << data.get_data_label(label_num->second) << ": ";
+        if (label_num != -1 && !(data.insert_labels && data.get_symbol(item.offset))) {
+            data.assembly += data.get_data_label(label_num) + ": ";
         }
 
         // Write data segment
-        write_data_to_stream(data.assembly, segment->second, data.format_data, data.insert_commas);
-        offset += (int) segment->second.size();
+        write_data(data.assembly, (const unsigned char *) data.buffer + item.offset, item.size, data.format_data, data.insert_commas);
     }
 
-    void write_data_to_stream(std::stringstream &stream, const std::vector<unsigned char> &bytes, bool format, bool commas) {
-        if (!bytes.empty()) {
-            stream << "u8 ";
+    /** Append a byte in upper-case hexadecimal. */
+    static void write_hex(std::string &out, unsigned char byte) {
+        const char *digits = "0123456789ABCDEF";
+
+        if (byte > 15)
+            out += digits[byte >> 4];
+
+        out += digits[byte & 15];
+    }
+
+    void write_data(std::string &out, const unsigned char *bytes, size_t count, bool format, bool commas) {
+        if (count != 0) {
+            out += "u8 ";
 
             if (format) {
                 std::vector<unsigned char> printable_chars;
 
-                for (int i = 0; i < bytes.size(); i++) {
+                for (size_t i = 0; i < count; i++) {
                     int byte = bytes[i];
 
                     // Printable character?
@@ -188,68 +347,71 @@ namespace disassembler {
 
                     // Write printable characters?
                     if (!printable_chars.empty()) {
-                        write_chars_to_stream(stream, printable_chars);
+                        write_chars(out, printable_chars);
                         printable_chars.clear();
-                        stream << (commas ? ", " : " ");
+                        out += commas ? ", " : " ";
                     }
 
                     if (byte < 10) {
                         // Print as decimal
-                        stream << std::dec << byte;
+                        out += (char) ('0' + byte);
                     } else {
                         // Print as hex
-                        stream << std::hex << std::uppercase << byte << "h";
+                        write_hex(out, byte);
+                        out += 'h';
                     }
 
-                    if (i < bytes.size() - 1)
-                        stream << (commas ? ", " : " ");
+                    if (i < count - 1)
+                        out += commas ? ", " : " ";
                 }
 
                 // Write left-over printable characters?
-                write_chars_to_stream(stream, printable_chars);
+                write_chars(out, printable_chars);
             } else {
-                stream << std::dec;
-
-                for (int i = 0; i < bytes.size(); i++) {
-                    stream << (int) bytes[i];
+                for (size_t i = 0; i < count; i++) {
+                    out += std::to_string(bytes[i]);
 
-                    if (i < bytes.size() - 1)
-                        stream << (commas ? ", " : " ");
+                    if (i < count - 1)
+                        out += commas ? ", " : " ";
                 }
             }
 
-            stream << "\n";
+            out += '\n';
         }
     }
 
-    void write_chars_to_stream(std::stringstream &stream, const std::vector<unsigned char> &chars) {
+    void write_chars(std::string &out, const std::vector<unsigned char> &chars) {
         if (!chars.empty()) {
             // Decide literal delimiter
             char delim = chars.size() == 1 ? '\'' : '"';
 
-            stream << delim;
+            out += delim;
 
             for (auto c : chars) {
                 if (c == 0) {
-                    stream << "\\0";
+                    out += "\\0";
                 } else if (c == '\n') {
-                    stream << "\\n";
+                    out += "\\n";
                 } else if (c == '\r') {
-                    stream << "\\r";
+                    out += "\\r";
                 } else if (c == delim) {
-                    stream << "\\" << c;
+                    out += '\\';
+                    out += (char) c;
                 } else {
-                    stream << c;
+                    out += (char) c;
                 }
             }
 
-            stream << delim;
+            out += delim;
         }
     }
 
-    void write_signature_to_stream(Data &data, assembler::instruction::Signature &signature, int &ptr) {
+    void write_signature(Data &data, const Item &item) {
         // Write mnemonic
-        data.assembly << signature.get_mnemonic() << " ";
+        auto &signature = *item.signature;
+        int ptr = item.offset;
+        data.assembly += signature.get_mnemonic();
+        data.assembly += ' ';
         ptr += sizeof(signature.get_opcode());
 
         if (data.debug)
@@ -262,54 +424,78 @@ namespace disassembler {
             const auto param = signature.get_param(i);
 
             // Extract value
-            unsigned long long value = extract_number(data.buffer, param->size, ptr);
+            unsigned long long value = extract_number(data.buffer, param->size, ptr, param->type == assembler::instruction::ParamType::Relative);
 
-            if (param->type == assembler::instruction::ParamType::Literal || param->type == assembler::instruction::ParamType::Address) {
+            // Relative jumps are written with their target, so are re-assembled as absolute jumps
+            if (param->type == assembler::instruction::ParamType::Relative)
+                value += item.offset + item.size;
+
+            if (param->type == assembler::instruction::ParamType::Literal || param->type == assembler::instruction::ParamType::Address ||
+                param->type == assembler::instruction::ParamType::Relative) {
                 std::string label;
+                bool is_target = (assembler::instruction::is_jmp_opcode(signature.get_opcode()) || signature.get_opcode() == OP_CALL_LIT) &&
+                                 i == count - 1;
+                int data_label = find_label(data.data_labels, (int) value);
+
+                // Symbol at jump/call target, address or data segment?
+                if (data.insert_labels && (is_target || param->type == assembler::instruction::ParamType::Address || data_label != -1)) {
+                    if (auto symbol = data.get_symbol((int) value))
+                        label = *symbol;
+                }
 
                 // Is JMP?
-                if (assembler::instruction::is_jmp_opcode(signature.get_opcode())) {
-                    auto pos_label = data.pos_labels.find((int) value);
+                if (label.empty() && assembler::instruction::is_jmp_opcode(signature.get_opcode()) && i == count - 1) {
+                    int pos_label = find_label(data.pos_labels, (int) value);
 
-                    if (pos_label != data.pos_labels.end()) {
-                        label = data.get_pos_label(pos_label->second);
+                    if (pos_label != -1) {
+                        label = data.get_pos_label(pos_label);
                     }
                 }
 
                 // Points to data segment?
+                if (label.empty() && data_label != -1) {
+                    label = data.get_data_label(data_label);
+                }
+
                 if (label.empty()) {
-                    auto data_label = data.data_labels.find((int) value);
+                    if (data.debug)
+                        std::cout << "\tArg: " << (param->type == assembler::instruction::ParamType::Address ? "address " : "literal ") << value << "\n";
 
-                    if (data_label != data.data_labels.end()) {
-                        label = data.get_data_label(data_label->second);
-                    }
+                    label = std::to_string(value);
+                } else if (data.debug) {
+                    std::cout << "\tArg: label (" << (param->type == assembler::instruction::ParamType::Address ? "addr.) " : "lit.) ") << label << " (" << value << ")\n";
                 }
 
                 if (param->type == assembler::instruction::ParamType::Address) {
-                    if (label.empty()) {
-                        if (data.debug)
-                            std::cout << "\tArg: address " << value << "\n";
+                    data.assembly += '[';
+                    data.assembly += label;
+                    data.assembly += ']';
+                } else {
+                    data.assembly += label;
+                }
+            } else if (param->type == assembler::instruction::ParamType::Indexed) {
+                // Indexed: <base: u8> <index: u8> <scale: u8> <disp: i32>
+                auto base = register_to_string((unsigned char) data.buffer[ptr]);
+                int scale = (unsigned char) data.buffer[ptr + 2];
+                int32_t disp = *(int32_t *) (data.buffer + ptr + 3);
 
-                        data.assembly << "[" << value << "]";
-                    } else {
-                        if (data.debug)
-                            std::cout << "\tArg: label (addr.) " << label << " (" << value << ")\n";
+                if (data.debug)
+                    std::cout << "\tArg: indexed\n";
 
-                        data.assembly << "[" << label << "]";
-                    }
-                } else {
-                    if (label.empty()) {
-                        if (data.debug)
-                            std::cout << "\tArg: literal " << value << "\n";
+                data.assembly += "[" + base;
 
-                        data.assembly << value;
-                    } else {
-                        if (data.debug)
-                            std::cout << "\tArg: label (lit.) " << label << " (" << value << ")\n";
+                if (scale != 0) {
+                    data.assembly += " + " + register_to_string((unsigned char) data.buffer[ptr + 1]);
 
-                        data.assembly << label;
-                    }
+                    if (scale != 1)
+                        data.assembly += "*" + std::to_string(scale);
                 }
+
+                // Always keep a term after the base, so "[r1 + 0]" doesn't read back as a register pointer
+                if (disp != 0 || scale == 0)
+                    data.assembly += (disp < 0 ? " - " : " + ") + std::to_string(std::abs((long long) disp));
+
+                data.assembly += ']';
             } else {
                 // Register/Register pointer
                 auto reg = register_to_string((int) value);
@@ -318,22 +504,22 @@ namespace disassembler {
                     if (data.debug)
                         std::cout << "\tArg: register pointer " << value << " ([" << reg << "])\n";
 
-                    data.assembly << "[" << reg << "]";
+                    data.assembly += "[" + reg + "]";
                 } else {
                     if (data.debug)
                         std::cout << "\tArg: register " << value << " (" << reg << ")\n";
 
-                    data.assembly << reg;
+                    data.assembly += reg;
                 }
             }
 
             if (i != count - 1)
-                data.assembly << (data.insert_commas ? ", " : " ");
+                data.assembly += data.insert_commas ? ", " : " ";
 
             ptr += param->size;
         }
 
-        data.assembly << "\n";
+        data.assembly += '\n';
     }
 
     std::string register_to_string(int reg) {
@@ -359,16 +545,16 @@ namespace disassembler {
         }
     }
 
-    unsigned long long extract_number(const char *buffer, int size, int ptr) {
+    unsigned long long extract_number(const char *buffer, int size, int ptr, bool is_signed) {
         switch (size) {
             case 1:
-                return (int8_t) buffer[ptr];
+                return is_signed ? (int8_t) buffer[ptr] : (uint8_t) buffer[ptr];
             case 2:
-                return *(int16_t *) (buffer + ptr);
+                return is_signed ? *(int16_t *) (buffer + ptr) : *(uint16_t *) (buffer + ptr);
             case 4:
-                return *(int32_t *) (buffer + ptr);
+                return is_signed ? *(int32_t *) (buffer + ptr) : *(uint32_t *) (buffer + ptr);
             case 8:
-                return *(int64_t *) (buffer + ptr);
+                return *(uint64_t *) (buffer + ptr);
             default:
                 return 0;
         }
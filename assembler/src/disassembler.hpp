@@ -8,21 +8,21 @@ namespace disassembler {
     /** Disassembler given data. */
     void disassemble(Data &data, message::List &msgs);
 
-    /** Write data segment starting at an offset to the stream. Offset incremented by segment size. */
-    void write_data_segment(Data &data, int &offset);
+    /** Write data item to the assembly. */
+    void write_data_segment(Data &data, const Item &item);
 
-    /** Write byte vector to stream. */
-    void write_data_to_stream(std::stringstream &stream, const std::vector<unsigned char> &bytes, bool format, bool commas);
+    /** Write bytes as a line of data. */
+    void write_data(std::string &out, const unsigned char *bytes, size_t count, bool format, bool commas);
 
     /** Write vector of printable characters. */
-    void write_chars_to_stream(std::stringstream &stream, const std::vector<unsigned char> &chars);
+    void write_chars(std::string &out, const std::vector<unsigned char> &chars);
 
-    /** Write signature to stream. ptr will be advanced by signature.get_bytes(). */
-    void write_signature_to_stream(Data &data, assembler::instruction::Signature &signature, int &ptr);
+    /** Write instruction item to the assembly. */
+    void write_signature(Data &data, const Item &item);
 
     /** Given a register offset, return string or "". */
     std::string register_to_string(int reg);
 
-    /** Extract number of given size in bytes (<= 8). */
-    unsigned long long extract_number(const char *buffer, int size, int ptr);
+    /** Extract number of given size in bytes (<= 8), sign- or zero-extending it. */
+    unsigned long long extract_number(const char *buffer, int size, int ptr, bool is_signed);
 }
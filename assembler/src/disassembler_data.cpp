@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <fstream>
 #include "disassembler_data.hpp"
 extern "C" {
@@ -60,13 +61,64 @@ namespace disassembler {
         return true;
     }
 
-    std::pair<const int, std::vector<unsigned char>> *Data::get_segment_in(int offset) {
-        for (auto &pair : data_offsets) {
-            if (offset >= pair.first && offset < pair.first + pair.second.size()) {
-                return &pair;
+    bool Data::load_symbol_file(const std::filesystem::path& path) {
+        return assembler::symbols::read(path, symbols);
+    }
+
+    const std::string *Data::get_symbol(int offset) const {
+        auto symbol = std::lower_bound(symbols.symbols.begin(), symbols.symbols.end(), offset, [](const auto &symbol, int offset) {
+            return symbol.address < (uint64_t) offset;
+        });
+
+        return offset >= 0 && symbol != symbols.symbols.end() && symbol->address == (uint64_t) offset ? &symbol->name : nullptr;
+    }
+
+    bool Data::is_data(int offset) const {
+        // Last item starting at or before offset
+        auto item = std::upper_bound(items.begin(), items.end(), offset, [](int offset, const Item &item) {
+            return offset < item.offset;
+        });
+
+        if (item == items.begin())
+            return false;
+
+        item--;
+        return item->signature == nullptr && offset < item->offset + item->size;
+    }
+
+    bool Data::is_item(int offset) const {
+        auto item = std::lower_bound(items.begin(), items.end(), offset, [](const Item &item, int offset) {
+            return item.offset < offset;
+        });
+
+        return item != items.end() && item->offset == offset;
+    }
+
+    void Data::split_data(std::vector<int> offsets) {
+        std::sort(offsets.begin(), offsets.end());
+
+        std::vector<Item> split;
+        split.reserve(items.size() + offsets.size());
+        auto next = offsets.begin();
+
+        for (const auto &item : items) {
+            if (item.signature != nullptr) {
+                split.push_back(item);
+                continue;
             }
+
+            int start = item.offset, end = item.offset + item.size;
+
+            for (; next != offsets.end() && *next < end; next++) {
+                if (*next > start) {
+                    split.push_back({ start, *next - start, nullptr });
+                    start = *next;
+                }
+            }
+
+            split.push_back({ start, end - start, nullptr });
         }
 
-        return nullptr;
+        items = std::move(split);
     }
 }
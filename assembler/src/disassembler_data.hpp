@@ -1,11 +1,21 @@
 #pragma once
 
 #include <filesystem>
-#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "instructions/signature.hpp"
+#include "symbol_file.hpp"
 
 namespace disassembler {
+    /** Bytes which are written as one instruction, or as one line of data. */
+    struct Item {
+        int offset;
+        int size;
+        assembler::instruction::Signature *signature; // Instruction, or nullptr if data
+    };
+
     struct Data {
         std::filesystem::path file_path; // Name of source file
 
@@ -13,6 +23,7 @@ namespace disassembler {
         bool format_data; // Format data constants
         bool insert_labels; // Insert labels
         bool insert_commas; // Insert commas between arguments/data items
+        bool recursive; // Follow control flow from the start address, rather than reading every opcode as code
 
         int start_addr;
         std::string main_label; // Contain "main" label name
@@ -23,11 +34,11 @@ namespace disassembler {
         size_t buffer_size; // Size of buffer
         char *buffer; // Pointer to buffer
 
-        std::stringstream assembly;
-        std::map<int, assembler::instruction::Signature *> instruction_offsets; // +offset -> instruction
-        std::map<int, std::vector<unsigned char>> data_offsets; // +offset -> bytes
-        std::map<int, int> data_labels; // +offset -> label ordinal ("data" + ordinal)
-        std::map<int, int> pos_labels; // +offset -> label ordinal ("pos" + ordinal)
+        std::string assembly;
+        std::vector<Item> items; // Instructions and data, sorted by offset
+        std::vector<std::pair<int, int>> data_labels; // (+offset, label ordinal ("data" + ordinal)), sorted by offset
+        std::vector<std::pair<int, int>> pos_labels; // (+offset, label ordinal ("pos" + ordinal)), sorted by offset
+        assembler::symbols::Table symbols; // Debug symbols, if the binary has a symbol file
 
         explicit Data(bool debug) {
             this->debug = debug;
@@ -36,6 +47,7 @@ namespace disassembler {
             format_data = false;
             insert_labels = true;
             insert_commas = false;
+            recursive = false;
             file_buffer_size = 0;
             file_buffer = nullptr;
             buffer_size = 0;
@@ -58,7 +70,19 @@ namespace disassembler {
         /** Load data from binary file. Set `file_path`. Return success. */
         bool load_binary_file(const std::filesystem::path& path);
 
-        /** Return data segment the given offset lies inside, or end. */
-        std::pair<const int, std::vector<unsigned char>> *get_segment_in(int offset);
+        /** Load debug symbols from the given file. Return success. */
+        bool load_symbol_file(const std::filesystem::path& path);
+
+        /** Get the name of the first symbol at the given offset, or nullptr if there is none. */
+        const std::string *get_symbol(int offset) const;
+
+        /** Return whether the given offset lies inside data. */
+        bool is_data(int offset) const;
+
+        /** Return whether an instruction or data begins at the given offset. */
+        bool is_item(int offset) const;
+
+        /** Split data so that a segment begins at each of the given offsets. */
+        void split_data(std::vector<int> offsets);
     };
 }
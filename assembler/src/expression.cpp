@@ -0,0 +1,181 @@
+#include "expression.hpp"
+
+namespace assembler::expression {
+    int get_precedence(char op) {
+        switch (op) {
+            case '|':
+                return 0;
+            case '^':
+                return 1;
+            case '&':
+                return 2;
+            case '<':
+            case '>':
+                return 3;
+            case '+':
+            case '-':
+                return 4;
+            case '*':
+            case '/':
+            case '%':
+                return 5;
+            default:
+                return -1;
+        }
+    }
+
+    /** Get the textual form of an operator. */
+    static std::string op_to_string(char op) {
+        switch (op) {
+            case '<':
+                return "<<";
+            case '>':
+                return ">>";
+            default:
+                return std::string(1, op);
+        }
+    }
+
+    /** Apply a binary operator. Only sums and differences may involve addresses, unless they are fixed. */
+    static bool apply(char op, const Value &a, const Value &b, const Context &context, Value &result, std::string &error) {
+        result = { 0, 0, nullptr };
+
+        if (op == '+') {
+            if (a.external && b.external) {
+                error = "Cannot add the addresses of two external labels";
+                return false;
+            }
+
+            result = { a.value + b.value, a.addresses + b.addresses, a.external ? a.external : b.external };
+            return true;
+        }
+
+        if (op == '-') {
+            if (b.external && a.external != b.external) {
+                error = "Cannot subtract the address of external label '" + *b.external + "'";
+                return false;
+            }
+
+            result = { a.value - b.value, a.addresses - b.addresses, a.external == b.external ? nullptr : a.external };
+
+            // An external address must be kept whole, as only it is filled in by the linker
+            if (result.external && result.addresses != 1) {
+                error = "Cannot subtract an address from external label '" + *result.external + "', as their distance is not known until linking";
+                return false;
+            }
+
+            return true;
+        }
+
+        if (context.relocatable && (a.addresses != 0 || b.addresses != 0)) {
+            error = "Operator " + op_to_string(op) + " cannot be applied to an address, as it is not known until linking";
+            return false;
+        }
+
+        switch (op) {
+            case '*':
+                result.value = (long long) ((unsigned long long) a.value * (unsigned long long) b.value);
+                return true;
+            case '/':
+            case '%':
+                if (b.value == 0) {
+                    error = "Division by zero";
+                    return false;
+                }
+
+                result.value = op == '/' ? a.value / b.value : a.value % b.value;
+                return true;
+            case '&':
+                result.value = a.value & b.value;
+                return true;
+            case '|':
+                result.value = a.value | b.value;
+                return true;
+            case '^':
+                result.value = a.value ^ b.value;
+                return true;
+            case '<':
+                result.value = b.value < 0 || b.value > 63 ? 0 : (long long) ((unsigned long long) a.value << b.value);
+                return true;
+            case '>':
+                result.value = b.value < 0 || b.value > 63 ? (a.value < 0 ? -1 : 0) : a.value >> b.value;
+                return true;
+            default:
+                error = "Unknown operator " + op_to_string(op);
+                return false;
+        }
+    }
+
+    bool evaluate(const Expression &expression, const Context &context, Value &result, std::string &error) {
+        std::vector<Value> stack;
+
+        for (const auto &token : expression) {
+            switch (token.type) {
+                case Token::Type::Number:
+                    stack.push_back({ (long long) token.value, 0, nullptr });
+                    break;
+                case Token::Type::Here:
+                    stack.push_back({ context.here, 1, nullptr });
+                    break;
+                case Token::Type::Label: {
+                    long long address;
+
+                    if (context.get_label(*token.label, address)) {
+                        stack.push_back({ address, 1, nullptr });
+                    } else if (context.relocatable) {
+                        stack.push_back({ 0, 1, token.label });
+                    } else {
+                        error = "Unresolved label reference '" + *token.label + "'";
+                        return false;
+                    }
+
+                    break;
+                }
+                case Token::Type::SizeOf: {
+                    long long address;
+
+                    if (!context.get_label(*token.label, address)) {
+                        error = "sizeof: label '" + *token.label + "' must be declared in this file";
+                        return false;
+                    }
+
+                    stack.push_back({ context.get_size(*token.label), 0, nullptr });
+                    break;
+                }
+                case Token::Type::Unary: {
+                    auto &value = stack.back();
+
+                    if (token.op == '+')
+                        break;
+
+                    if (context.relocatable && value.addresses != 0) {
+                        error = "Operator " + op_to_string(token.op) + " cannot be applied to an address, as it is not known until linking";
+                        return false;
+                    }
+
+                    value.value = token.op == '-' ? -value.value : ~value.value;
+                    break;
+                }
+                case Token::Type::Binary: {
+                    Value b = stack.back();
+                    stack.pop_back();
+                    Value a = stack.back();
+
+                    if (!apply(token.op, a, b, context, stack.back(), error))
+                        return false;
+
+                    break;
+                }
+            }
+        }
+
+        result = stack.back();
+
+        if ((context.relocatable && result.addresses != 0 && result.addresses != 1) || (result.external && result.addresses != 1)) {
+            error = "Expression must be a constant, or a single address plus a constant";
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/** Constant expressions, which may be given in place of a literal, an address or a data item. Expressions are parsed
+ * into reverse Polish notation, and evaluated once every label has been laid out. */
+namespace assembler::expression {
+    struct Token {
+        enum class Type {
+            Number,
+            Label,
+            Here, // `$`: address of the current instruction or data
+            SizeOf, // sizeof(label): byte-size of the instruction or data at a label
+            Unary, // Operator applied to the top value
+            Binary // Operator applied to the top two values
+        };
+
+        Type type;
+        unsigned long long value; // If Number
+        const std::string *label; // If Label or SizeOf: interned label name, owned by assembler::Data
+        char op; // If Unary or Binary. Shifts are '<' and '>'
+    };
+
+    using Expression = std::vector<Token>;
+
+    /** Result of evaluating an expression: `value`, plus `addresses` times the address at which this file is placed.
+     * An address may also be that of an external label, in which case `value` is relative to it. */
+    struct Value {
+        long long value;
+        int addresses;
+        const std::string *external;
+    };
+
+    /** Supplies the symbols an expression may refer to. */
+    struct Context {
+        long long here; // Value of `$`
+        bool relocatable; // Are addresses moved when linking? If so, undeclared labels are external.
+        std::function<bool(const std::string &, long long &)> get_label; // Get address of a label. Return false if undeclared.
+        std::function<long long(const std::string &)> get_size; // Get sizeof(label)
+    };
+
+    /** Get the precedence of a binary operator, or -1 if <op> is not one. Higher binds tighter. */
+    int get_precedence(char op);
+
+    /** Evaluate an expression. Return false, setting <error>, if it cannot be. */
+    bool evaluate(const Expression &expression, const Context &context, Value &result, std::string &error);
+}
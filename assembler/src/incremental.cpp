@@ -0,0 +1,178 @@
+#include "incremental.hpp"
+#include "binary_io.hpp"
+
+#include <fstream>
+#include <sstream>
+
+namespace assembler::incremental {
+    using namespace binary_io;
+
+    /** Magic bytes at the start of a cache file. */
+    static const char magic[4] = { 'C', 'V', 'I', 'A' };
+
+    std::filesystem::path get_cache_path(const std::filesystem::path &directory, const std::filesystem::path &source,
+                                         const std::string &options) {
+        std::error_code error;
+        auto canonical = std::filesystem::weakly_canonical(source, error).string();
+        std::stringstream name;
+        name << source.filename().string() << '.' << std::hex
+             << hash_bytes(options.data(), options.size(), hash_bytes(canonical.data(), canonical.size())) << ".inc";
+
+        return directory / name.str();
+    }
+
+    bool load(const std::filesystem::path &cache_file, Entry &entry) {
+        std::ifstream in(cache_file, std::ios::binary);
+        uint32_t count;
+        uint64_t size;
+
+        if (!read_header(in, magic, version) || !read_int(in, count))
+            return false;
+
+        for (uint32_t i = 0; i < count; i++) {
+            std::string path;
+            uint64_t hash;
+
+            if (!read_string(in, path) || !read_int(in, hash))
+                return false;
+
+            entry.dependencies.emplace_back(path, hash);
+        }
+
+        if (!read_int(in, size))
+            return false;
+
+        entry.output.resize(size);
+
+        if (!in.read((char *) entry.output.data(), (std::streamsize) size) || !read_int(in, count))
+            return false;
+
+        entry.instructions.resize(count);
+
+        for (auto &record : entry.instructions) {
+            uint8_t arg_count;
+
+            if (!read_string(in, record.text) || !read_string(in, record.mnemonic) || !read_int(in, arg_count))
+                return false;
+
+            record.args.resize(arg_count);
+
+            for (auto &arg : record.args) {
+                uint8_t type;
+
+                if (!read_int(in, type) || !read_int(in, arg.value) || !read_string(in, arg.label))
+                    return false;
+
+                arg.type = (instruction::ArgumentType) type;
+            }
+        }
+
+        return true;
+    }
+
+    bool is_up_to_date(const Entry &entry) {
+        if (entry.dependencies.empty())
+            return false;
+
+        for (const auto &dependency : entry.dependencies) {
+            uint64_t hash;
+
+            if (!hash_file(dependency.first, hash) || hash != dependency.second)
+                return false;
+        }
+
+        return true;
+    }
+
+    void restore(const Entry &entry, Data &data) {
+        data.incremental = true;
+
+        for (const auto &record : entry.instructions) {
+            std::vector<instruction::Argument> arguments;
+            std::vector<instruction::ArgumentType> argument_types;
+
+            for (const auto &arg : record.args) {
+                instruction::Argument argument(arg.type, arg.value);
+
+                if (argument.is_label())
+                    argument.set_label(data.intern_label(arg.label));
+
+                arguments.push_back(argument);
+                argument_types.push_back(arg.type);
+            }
+
+            // Signatures may have changed since, in which case the text is simply parsed again
+            auto signature = instruction::Signature::find(record.mnemonic, argument_types);
+
+            if (signature != nullptr)
+                data.instruction_cache.insert({ record.text, { instruction::Instruction(*signature, arguments), false } });
+        }
+    }
+
+    void store(const std::filesystem::path &cache_file, const std::vector<std::filesystem::path> &dependencies,
+               const Data &data, const std::filesystem::path &output_file) {
+        Entry entry;
+
+        for (const auto &dependency : dependencies) {
+            uint64_t hash;
+
+            if (!hash_file(dependency, hash))
+                return;
+
+            entry.dependencies.emplace_back(dependency, hash);
+        }
+
+        {
+            std::ifstream in(output_file, std::ios::binary);
+
+            if (!in.good())
+                return;
+
+            entry.output.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(cache_file.parent_path(), error);
+
+        // Only keep instructions which are still in use, so the cache does not grow without bound
+        write_atomically(cache_file, [&](std::ostream &out) {
+            write_header(out, magic, version);
+
+            write_int<uint32_t>(out, entry.dependencies.size());
+
+            for (const auto &dependency : entry.dependencies) {
+                write_string(out, dependency.first.string());
+                write_int(out, dependency.second);
+            }
+
+            write_int<uint64_t>(out, entry.output.size());
+            out.write((const char *) entry.output.data(), (std::streamsize) entry.output.size());
+
+            uint32_t count = 0;
+
+            for (const auto &pair : data.instruction_cache)
+                count += pair.second.used;
+
+            write_int(out, count);
+
+            for (const auto &[text, cached] : data.instruction_cache) {
+                if (!cached.used)
+                    continue;
+
+                const auto &instruction = cached.instruction;
+                write_string(out, text);
+                write_string(out, instruction.signature->get_mnemonic());
+                write_int<uint8_t>(out, instruction.arg_count);
+
+                for (int i = 0; i < instruction.arg_count; i++) {
+                    const auto &argument = instruction.args[i];
+                    bool is_label = argument.is_label();
+
+                    write_int<uint8_t>(out, (uint8_t) argument.get_type());
+                    write_int<unsigned long long>(out, is_label ? 0 : argument.get_data());
+                    write_string(out, is_label ? *argument.get_label() : "");
+                }
+            }
+        });
+    }
+}
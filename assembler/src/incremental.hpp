@@ -0,0 +1,53 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "assembler_data.hpp"
+
+/** Incremental assembly (`--incremental <dir>`). For each source file, a cache file records the source and every file it
+ * includes (with content hashes), the output which was written, and every instruction which was parsed.
+ * If no file has changed since, the output is re-written as-is; otherwise only lines whose text is new are parsed. */
+namespace assembler::incremental {
+    /** Bump whenever the on-disk format, or the output of the assembler, changes. */
+    constexpr uint32_t version = 4;
+
+    /** Instruction as stored on disk. */
+    struct Record {
+        struct Arg {
+            instruction::ArgumentType type;
+            unsigned long long value; // If not a label
+            std::string label; // If a label
+        };
+
+        std::string text; // Text of the line, from its mnemonic onwards
+        std::string mnemonic;
+        std::vector<Arg> args;
+    };
+
+    struct Entry {
+        std::vector<std::pair<std::filesystem::path, uint64_t>> dependencies; // Source and included files, and their hashes
+        std::vector<unsigned char> output; // Contents of the output file
+        std::vector<Record> instructions;
+    };
+
+    /** Get path of the cache file in <directory> for the given source file, assembled with the given <options> (anything
+     * other than the source which affects the output). */
+    std::filesystem::path get_cache_path(const std::filesystem::path &directory, const std::filesystem::path &source,
+                                         const std::string &options);
+
+    /** Read the cache file. Return whether this was successful. */
+    bool load(const std::filesystem::path &cache_file, Entry &entry);
+
+    /** Have none of the entry's files changed? */
+    bool is_up_to_date(const Entry &entry);
+
+    /** Fill the instruction cache of <data> from the entry, and enable incremental parsing. */
+    void restore(const Entry &entry, Data &data);
+
+    /** Cache the result of assembling into <output_file>, having read the given files. Failure to write to disk is
+     * silently ignored. */
+    void store(const std::filesystem::path &cache_file, const std::vector<std::filesystem::path> &dependencies,
+               const Data &data, const std::filesystem::path &output_file);
+}
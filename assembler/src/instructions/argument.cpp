@@ -3,6 +3,7 @@ extern "C" {
 #include "util.h"
 }
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <iomanip>
@@ -13,11 +14,11 @@ namespace assembler::instruction {
         this->m_data = data;
     }
 
-    bool Argument::is_label() {
+    bool Argument::is_label() const {
         return m_type == ArgumentType::LabelAddress || m_type == ArgumentType::LabelLiteral;
     }
 
-    void Argument::print(std::ostream &out) {
+    void Argument::print(std::ostream &out) const {
         switch (m_type) {
             case ArgumentType::Literal:
                 out << "literal " << m_data << " {" << std::hex;
@@ -40,37 +41,41 @@ namespace assembler::instruction {
             case ArgumentType::RegisterPointer:
                 out << "register pointer " << m_data;
                 break;
+            case ArgumentType::Indexed:
+                out << "indexed {base " << (m_data & 0xFF) << ", index " << ((m_data >> 8) & 0xFF)
+                    << ", scale " << ((m_data >> 16) & 0xFF) << ", disp " << (int32_t) (m_data >> 24) << "}";
+                break;
             case ArgumentType::LabelLiteral:
-                out << "label (lit.) \"" << *(std::string *) m_data << "\"";
+                out << "label (lit.) \"" << *m_label << "\"";
                 break;
             case ArgumentType::LabelAddress:
-                out << "label (addr.) \"" << *(std::string *) m_data << "\"";
+                out << "label (addr.) \"" << *m_label << "\"";
                 break;
         }
     }
 
-    void Argument::set_label(const std::string &label) {
-        auto ptr = new std::string(label);
-        m_data = (unsigned long long) ptr;
+    unsigned long long Argument::pack_indexed(int base, int index, int scale, int disp) {
+        return (unsigned long long) (base & 0xFF)
+            | (unsigned long long) (index & 0xFF) << 8
+            | (unsigned long long) (scale & 0xFF) << 16
+            | (unsigned long long) (uint32_t) disp << 24;
+    }
+
+    void Argument::set_label(const std::string *label) {
+        m_label = label;
     }
 
     void Argument::transform_label(unsigned long long value) {
         if (m_type == ArgumentType::LabelAddress) {
-            delete (std::string *) m_data;
             m_type = ArgumentType::Address;
             m_data = value;
         } else if (m_type == ArgumentType::LabelLiteral) {
-            delete (std::string *) m_data;
             m_type = ArgumentType::Literal;
             m_data = value;
         }
     }
 
     void Argument::update(ArgumentType type, unsigned long long int data) {
-        if (is_label()) {
-            delete (std::string *) data;
-        }
-
         m_type = type;
         m_data = data;
     }
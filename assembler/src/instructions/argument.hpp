@@ -9,6 +9,7 @@ namespace assembler::instruction {
         Address,
         Register,
         RegisterPointer,
+        Indexed,
         LabelLiteral,
         LabelAddress
     };
@@ -16,7 +17,11 @@ namespace assembler::instruction {
     class Argument {
     private:
         ArgumentType m_type;
-        unsigned long long m_data;
+
+        union {
+            unsigned long long m_data;
+            const std::string *m_label; // If is_label(): interned label name, owned by assembler::Data
+        };
 
     public:
         Argument() {
@@ -31,7 +36,7 @@ namespace assembler::instruction {
         [[nodiscard]] unsigned long long get_data() const { return m_data; }
 
         /** Interpret `data` as a label. */
-        [[nodiscard]] std::string *get_label() const { return (std::string *) m_data; };
+        [[nodiscard]] const std::string *get_label() const { return m_label; };
 
         void update(ArgumentType type, unsigned long long data);
 
@@ -39,15 +44,18 @@ namespace assembler::instruction {
         void transform_address_equivalent();
 
         /** Is this argument a label? */
-        bool is_label();
+        [[nodiscard]] bool is_label() const;
 
-        /** Set value to a label. */
-        void set_label(const std::string &label);
+        /** Set value to an interned label name. */
+        void set_label(const std::string *label);
 
         /** Transform label to constant with the given value. */
         void transform_label(unsigned long long value);
 
+        /** Pack an indexed operand [base + index * scale + disp]. A scale of 0 means no index. */
+        static unsigned long long pack_indexed(int base, int index, int scale, int disp);
+
         /** Print the label. */
-        void print(std::ostream& out = std::cout);
+        void print(std::ostream& out = std::cout) const;
     };
 }
@@ -1,39 +1,43 @@
+#include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <utility>
 
 #include "instruction.hpp"
 #include "argument.hpp"
 
 namespace assembler::instruction {
-    void Instruction::print() {
+    void Instruction::print() const {
         std::cout << "Mnemonic \"" << signature->get_mnemonic() << "\"; Opcode = " << std::hex << signature->get_opcode() << std::dec << "; "
-            << get_bytes() << " bytes; " << args.size() << " argument(s)\n";
+            << get_bytes() << " bytes; " << arg_count << " argument(s)\n";
 
-        for (Argument arg : args) {
+        for (int i = 0; i < arg_count; i++) {
             std::cout << "\t- ";
-            arg.print();
+            args[i].print();
             std::cout << '\n';
         }
     }
 
-    Instruction::Instruction(Signature &signature, std::vector<Argument> arguments) {
+    Instruction::Instruction(Signature &signature, const std::vector<Argument> &arguments) {
         this->signature = &signature;
-        args = std::move(arguments);
+        arg_count = (int) std::min(arguments.size(), (size_t) max_args);
+        std::copy(arguments.begin(), arguments.begin() + arg_count, args);
     }
 
     int Instruction::get_bytes() const {
         return signature ? signature->get_bytes() : 0;
     }
 
-    void Instruction::write(std::ostream &stream) {
+    void Instruction::write(unsigned char *buffer) const {
         auto opcode = signature->get_opcode();
-        stream.write((char *) &opcode, sizeof(opcode));
+        std::memcpy(buffer, &opcode, sizeof(opcode));
+        buffer += sizeof(opcode);
 
         for (int i = 0; i < signature->param_count(); i++) {
             auto param = signature->get_param(i);
             auto arg_data = args[i].get_data();
 
-            stream.write((char *) &arg_data, param->size);
+            std::memcpy(buffer, &arg_data, param->size);
+            buffer += param->size;
         }
     }
 }
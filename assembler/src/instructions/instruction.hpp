@@ -3,17 +3,22 @@
 #include "signature.hpp"
 
 namespace assembler::instruction {
+    /** Maximum number of arguments an instruction may take. */
+    constexpr int max_args = 3;
+
     class Instruction {
     public:
         Signature *signature;
-        std::vector<Argument> args;
+        Argument args[max_args];
+        int arg_count;
 
-        Instruction(Signature &signature, std::vector<Argument> arguments);
+        Instruction(Signature &signature, const std::vector<Argument> &arguments);
 
         [[nodiscard]] int get_bytes() const;
 
-        void write(std::ostream& stream);
+        /** Write encoded instruction to <buffer>, which must have room for get_bytes() bytes. */
+        void write(unsigned char *buffer) const;
 
-        void print();
+        void print() const;
     };
 }
@@ -2,7 +2,8 @@
 #include "signatures.hpp"
 #include "argument.hpp"
 
-#include <algorithm>
+#include <limits>
+#include <unordered_map>
 
 namespace assembler::instruction {
     Signature::Signature(std::string mnemonic, std::vector<Param> params, OPCODE_T opcode) {
@@ -11,40 +12,89 @@ namespace assembler::instruction {
         m_opcode = opcode;
     }
 
-    bool Signature::exists(const std::string &mnemonic) {
-        return std::any_of(signature_list.begin(), signature_list.end(), [&](const auto &signature) {
-            return signature.m_mnemonic == mnemonic;
-        });
+    /** A parameter list is keyed by its arity (low byte) and the kind of each parameter (3 bits each). */
+    static inline void add_param_to_key(uint64_t &key, size_t i, ParamType type) {
+        key |= (uint64_t) type << (8 + 3 * i);
     }
 
-    Signature *Signature::find(const std::string& mnemonic, const std::vector<ArgumentType>& args) {
-        for (auto &signature : signature_list) {
-            if (signature.m_mnemonic == mnemonic && signature.m_params.size() == args.size()) {
-                bool match = true;
-
-                for (int i = 0; i < args.size(); ++i) {
-                    if (!is_match(args[i], signature.get_param(i)->type)) {
-                        match = false;
-                        break;
-                    }
-                }
-
-                if (match)
-                    return &signature;
+    /** Get the parameter kind which the given argument type matches. */
+    static bool param_type_of(ArgumentType arg, ParamType &type) {
+        switch (arg) {
+            case ArgumentType::Literal:
+            case ArgumentType::LabelLiteral:
+                type = ParamType::Literal;
+                return true;
+            case ArgumentType::Address:
+            case ArgumentType::LabelAddress:
+                type = ParamType::Address;
+                return true;
+            case ArgumentType::Register:
+                type = ParamType::Register;
+                return true;
+            case ArgumentType::RegisterPointer:
+                type = ParamType::RegisterPointer;
+                return true;
+            case ArgumentType::Indexed:
+                type = ParamType::Indexed;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /** Lookup tables into `signature_list`, built on first use. Where entries collide, the earliest signature wins. */
+    struct SignatureIndex {
+        std::unordered_map<std::string, std::unordered_map<uint64_t, Signature *>> by_mnemonic; // mnemonic -> key -> signature
+        std::vector<Signature *> by_opcode; // Dense table indexed by opcode
+
+        SignatureIndex() : by_opcode((size_t) std::numeric_limits<OPCODE_T>::max() + 1, nullptr) {
+            for (auto &signature : signature_list) {
+                uint64_t key = signature.param_count();
+
+                for (size_t i = 0; i < signature.param_count(); i++)
+                    add_param_to_key(key, i, signature.get_param((int) i)->type);
+
+                by_mnemonic[signature.get_mnemonic()].insert({ key, &signature });
+
+                if (by_opcode[signature.get_opcode()] == nullptr)
+                    by_opcode[signature.get_opcode()] = &signature;
             }
         }
 
-        return nullptr;
+        static SignatureIndex &get() {
+            static SignatureIndex index;
+            return index;
+        }
+    };
+
+    bool Signature::exists(const std::string &mnemonic) {
+        auto &index = SignatureIndex::get().by_mnemonic;
+        return index.find(mnemonic) != index.end();
     }
 
-    Signature *Signature::find(OPCODE_T opcode) {
-        for (auto &signature : signature_list) {
-            if (signature.m_opcode == opcode) {
-                return &signature;
-            }
+    Signature *Signature::find(const std::string& mnemonic, const std::vector<ArgumentType>& args) {
+        auto &index = SignatureIndex::get().by_mnemonic;
+        auto candidates = index.find(mnemonic);
+
+        if (candidates == index.end())
+            return nullptr;
+
+        uint64_t key = args.size();
+        ParamType type;
+
+        for (size_t i = 0; i < args.size(); i++) {
+            if (!param_type_of(args[i], type))
+                return nullptr;
+
+            add_param_to_key(key, i, type);
         }
 
-        return nullptr;
+        auto signature = candidates->second.find(key);
+        return signature == candidates->second.end() ? nullptr : signature->second;
+    }
+
+    Signature *Signature::find(OPCODE_T opcode) {
+        return SignatureIndex::get().by_opcode[opcode];
     }
 
     int Signature::get_bytes() {
@@ -67,8 +117,46 @@ namespace assembler::instruction {
                 return arg == ArgumentType::RegisterPointer;
             case ParamType::Register:
                 return arg == ArgumentType::Register;
+            case ParamType::Indexed:
+                return arg == ArgumentType::Indexed;
             default:
                 return false;
         }
     }
+
+    OPCODE_T get_relative_jmp_opcode(OPCODE_T opcode, int size) {
+        OPCODE_T rel16;
+
+        switch (opcode) {
+            case OP_JMP_LIT:
+                rel16 = OP_JMP_REL16;
+                break;
+            case OP_JMP_EQ_LIT:
+                rel16 = OP_JMP_EQ_REL16;
+                break;
+            case OP_JMP_GT_LIT:
+                rel16 = OP_JMP_GT_REL16;
+                break;
+            case OP_JMP_GE_LIT:
+                rel16 = OP_JMP_GE_REL16;
+                break;
+            case OP_JMP_LT_LIT:
+                rel16 = OP_JMP_LT_REL16;
+                break;
+            case OP_JMP_LE_LIT:
+                rel16 = OP_JMP_LE_REL16;
+                break;
+            case OP_JMP_NEQ_LIT:
+                rel16 = OP_JMP_NEQ_REL16;
+                break;
+            default:
+                // Already relative
+                if (opcode < OP_JMP_REL16 || opcode > OP_JMP_NEQ_REL32)
+                    return 0;
+
+                rel16 = opcode & ~1;
+        }
+
+        return size == 2 ? rel16 : (OPCODE_T) (rel16 + 1);
+    }
 }
@@ -3,6 +3,7 @@
 #include "processor/src/opcodes.h"
 #include "argument.hpp"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -11,9 +12,14 @@ namespace assembler::instruction {
         Literal,
         Address,
         Register,
-        RegisterPointer
+        RegisterPointer,
+        Indexed,
+        Relative // Jump target, encoded as an offset from the following instruction
     };
 
+    /** Byte-size of an encoded indexed operand: `<base: u8> <index: u8> <scale: u8> <disp: i32>`. */
+    constexpr int indexed_operand_size = 3 + sizeof(int32_t);
+
     struct Param {
         ParamType type;
         int size;
@@ -53,8 +59,27 @@ namespace assembler::instruction {
     /** Return whether the argument matches against the parameter. */
     bool is_match(ArgumentType arg, ParamType param);
 
-    /** Check if opcode is a JMP instruction. */
+    /** Check if opcode is a JMP instruction. Its final parameter is the jump target. */
     inline bool is_jmp_opcode(OPCODE_T opcode) {
-        return (opcode & 0xFFF0) == 0x00E0;
+        return (opcode & 0xFFE0) == 0x00E0 || (opcode >= OP_JMP_REL16 && opcode <= OP_JMP_NEQ_REL32);
+    }
+
+    /** Check if execution never continues from an opcode to the next instruction. */
+    inline bool is_terminator_opcode(OPCODE_T opcode) {
+        switch (opcode) {
+            case OP_JMP_LIT:
+            case OP_JMP_REG:
+            case OP_JMP_REL16:
+            case OP_JMP_REL32:
+            case OP_RET:
+            case OP_HALT:
+                return true;
+            default:
+                return false;
+        }
     }
+
+    /** Get the relative form of a literal (or relative) jump with an offset of the given byte-size (2 or 4), or 0 if there is
+     * none. */
+    OPCODE_T get_relative_jmp_opcode(OPCODE_T opcode, int size);
 }
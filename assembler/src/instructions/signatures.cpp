@@ -54,6 +54,18 @@ namespace assembler::instruction {
             { "mov32", { { ParamType::Register, 1 }, { ParamType::RegisterPointer, 1 } }, OP_MOV32_REG_REGPTR },
             { "mov64", { { ParamType::Register, 1 }, { ParamType::RegisterPointer, 1 } }, OP_MOV64_REG_REGPTR },
 
+            { "mov", { { ParamType::Indexed, indexed_operand_size }, { ParamType::Register, 1 } }, OP_MOV_IDX_REG },
+            { "mov8", { { ParamType::Indexed, indexed_operand_size }, { ParamType::Register, 1 } }, OP_MOV8_IDX_REG },
+            { "mov16", { { ParamType::Indexed, indexed_operand_size }, { ParamType::Register, 1 } }, OP_MOV16_IDX_REG },
+            { "mov32", { { ParamType::Indexed, indexed_operand_size }, { ParamType::Register, 1 } }, OP_MOV32_IDX_REG },
+            { "mov64", { { ParamType::Indexed, indexed_operand_size }, { ParamType::Register, 1 } }, OP_MOV64_IDX_REG },
+
+            { "mov", { { ParamType::Register, 1 }, { ParamType::Indexed, indexed_operand_size } }, OP_MOV_REG_IDX },
+            { "mov8", { { ParamType::Register, 1 }, { ParamType::Indexed, indexed_operand_size } }, OP_MOV8_REG_IDX },
+            { "mov16", { { ParamType::Register, 1 }, { ParamType::Indexed, indexed_operand_size } }, OP_MOV16_REG_IDX },
+            { "mov32", { { ParamType::Register, 1 }, { ParamType::Indexed, indexed_operand_size } }, OP_MOV32_REG_IDX },
+            { "mov64", { { ParamType::Register, 1 }, { ParamType::Indexed, indexed_operand_size } }, OP_MOV64_REG_IDX },
+
             { "and", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(WORD_T) } }, OP_AND_REG_LIT },
             { "and8", { { ParamType::Register, 1 }, { ParamType::Literal, 1 } }, OP_AND8_REG_LIT },
             { "and16", { { ParamType::Register, 1 }, { ParamType::Literal, 2 } }, OP_AND16_REG_LIT },
@@ -93,6 +105,16 @@ namespace assembler::instruction {
             { "sll", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(WORD_T) } }, OP_LLSHIFT_LIT },
             { "sll", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_LLSHIFT_REG },
 
+            { "rol", { { ParamType::Register, 1 }, { ParamType::Literal, 1 } }, OP_ROTL_LIT },
+            { "rol", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_ROTL_REG },
+            { "ror", { { ParamType::Register, 1 }, { ParamType::Literal, 1 } }, OP_ROTR_LIT },
+            { "ror", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_ROTR_REG },
+
+            { "popc", { { ParamType::Register, 1 } }, OP_POPCNT },
+            { "clz", { { ParamType::Register, 1 } }, OP_CLZ },
+            { "ctz", { { ParamType::Register, 1 } }, OP_CTZ },
+            { "bswp", { { ParamType::Register, 1 } }, OP_BSWAP },
+
             { "ci8i16", { { ParamType::Register, 1 } }, OP_CVT_i8_i16 },
             { "ci16i8", { { ParamType::Register, 1 } }, OP_CVT_i16_i8 },
             { "ci16i32", { { ParamType::Register, 1 } }, OP_CVT_i16_i32 },
@@ -108,6 +130,7 @@ namespace assembler::instruction {
             { "addf32", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(float) } }, OP_ADDF32_REG_LIT },
             { "addf64", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(double) } }, OP_ADDF64_REG_LIT },
             { "add", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_ADD_REG_REG },
+            { "add", { { ParamType::Register, 1 }, { ParamType::Indexed, indexed_operand_size } }, OP_ADD_REG_IDX },
             { "addf32", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_ADDF32_REG_REG },
             { "addf64", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_ADDF64_REG_REG },
             { "add", { { ParamType::Literal, sizeof(WORD_T) }, { ParamType::Address, sizeof(UWORD_T) }, { ParamType::Address, sizeof(UWORD_T) } }, OP_ADD_MEM_MEM },
@@ -117,6 +140,7 @@ namespace assembler::instruction {
             { "subf32", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(float) } }, OP_SUBF32_REG_LIT },
             { "subf64", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(double) } }, OP_SUBF64_REG_LIT },
             { "sub", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_SUB_REG_REG },
+            { "sub", { { ParamType::Register, 1 }, { ParamType::Indexed, indexed_operand_size } }, OP_SUB_REG_IDX },
             { "subf32", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_SUBF32_REG_REG },
             { "subf64", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_SUBF64_REG_REG },
             { "sub", { { ParamType::Literal, sizeof(WORD_T) }, { ParamType::Address, sizeof(UWORD_T) }, { ParamType::Address, sizeof(UWORD_T) } }, OP_SUB_MEM_MEM },
@@ -127,6 +151,8 @@ namespace assembler::instruction {
             { "mul", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_MUL_REG_REG },
             { "mulf32", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_MULF32_REG_REG },
             { "mulf64", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_MULF64_REG_REG },
+            { "mulh", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_MULHI_REG_REG },
+            { "mulhu", { { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_UMULHI_REG_REG },
 
             { "div", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(WORD_T) } }, OP_DIV_REG_LIT },
             { "divf32", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(float) } }, OP_DIVF32_REG_LIT },
@@ -159,32 +185,80 @@ namespace assembler::instruction {
             { "jle", { { ParamType::Literal, sizeof(WORD_T) } }, OP_JMP_LE_LIT },
             { "jle", { { ParamType::Register, 1 } }, OP_JMP_LE_REG },
 
+            // Relative jumps: only chosen by branch relaxation, as no argument matches ParamType::Relative
+            { "jmp", { { ParamType::Relative, sizeof(int16_t) } }, OP_JMP_REL16 },
+            { "jmp", { { ParamType::Relative, sizeof(int32_t) } }, OP_JMP_REL32 },
+            { "jeq", { { ParamType::Relative, sizeof(int16_t) } }, OP_JMP_EQ_REL16 },
+            { "jeq", { { ParamType::Relative, sizeof(int32_t) } }, OP_JMP_EQ_REL32 },
+            { "jne", { { ParamType::Relative, sizeof(int16_t) } }, OP_JMP_NEQ_REL16 },
+            { "jne", { { ParamType::Relative, sizeof(int32_t) } }, OP_JMP_NEQ_REL32 },
+            { "jgt", { { ParamType::Relative, sizeof(int16_t) } }, OP_JMP_GT_REL16 },
+            { "jgt", { { ParamType::Relative, sizeof(int32_t) } }, OP_JMP_GT_REL32 },
+            { "jge", { { ParamType::Relative, sizeof(int16_t) } }, OP_JMP_GE_REL16 },
+            { "jge", { { ParamType::Relative, sizeof(int32_t) } }, OP_JMP_GE_REL32 },
+            { "jlt", { { ParamType::Relative, sizeof(int16_t) } }, OP_JMP_LT_REL16 },
+            { "jlt", { { ParamType::Relative, sizeof(int32_t) } }, OP_JMP_LT_REL32 },
+            { "jle", { { ParamType::Relative, sizeof(int16_t) } }, OP_JMP_LE_REL16 },
+            { "jle", { { ParamType::Relative, sizeof(int32_t) } }, OP_JMP_LE_REL32 },
+
+            { "djnz", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_DEC_NZ },
+            { "jeq", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(WORD_T) }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_EQ_REG_LIT },
+            { "jeq", { { ParamType::Register, 1 }, { ParamType::Register, 1 }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_EQ_REG_REG },
+            { "jgt", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(WORD_T) }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_GT_REG_LIT },
+            { "jgt", { { ParamType::Register, 1 }, { ParamType::Register, 1 }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_GT_REG_REG },
+            { "jge", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(WORD_T) }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_GE_REG_LIT },
+            { "jge", { { ParamType::Register, 1 }, { ParamType::Register, 1 }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_GE_REG_REG },
+            { "jlt", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(WORD_T) }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_LT_REG_LIT },
+            { "jlt", { { ParamType::Register, 1 }, { ParamType::Register, 1 }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_LT_REG_REG },
+            { "jle", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(WORD_T) }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_LE_REG_LIT },
+            { "jle", { { ParamType::Register, 1 }, { ParamType::Register, 1 }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_LE_REG_REG },
+            { "jne", { { ParamType::Register, 1 }, { ParamType::Literal, sizeof(WORD_T) }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_NEQ_REG_LIT },
+            { "jne", { { ParamType::Register, 1 }, { ParamType::Register, 1 }, { ParamType::Literal, sizeof(UWORD_T) } }, OP_JMP_NEQ_REG_REG },
+
             { "psh", { { ParamType::Literal, sizeof(WORD_T) } }, OP_PUSH_LIT },
             { "psh8", { { ParamType::Literal, 1 } }, OP_PUSH8_LIT },
             { "psh16", { { ParamType::Literal, 2 } }, OP_PUSH16_LIT },
             { "psh32", { { ParamType::Literal, 4 } }, OP_PUSH32_LIT },
             { "psh64", { { ParamType::Literal, 8 } }, OP_PUSH64_LIT },
             { "psh", { { ParamType::Address, sizeof(UWORD_T) } }, OP_PUSH_MEM },
-            { "psh8", { { ParamType::Address, 1 } }, OP_PUSH8_MEM },
-            { "psh16", { { ParamType::Address, 2 } }, OP_PUSH16_MEM },
-            { "psh32", { { ParamType::Address, 4 } }, OP_PUSH32_MEM },
-            { "psh64", { { ParamType::Address, 8 } }, OP_PUSH64_MEM },
-            { "psh", { { ParamType::Literal, sizeof(WORD_T) }, { ParamType::Address, sizeof(UWORD_T) } }, OP_PUSHN_MEM },
+            { "psh8", { { ParamType::Address, sizeof(UWORD_T) } }, OP_PUSH8_MEM },
+            { "psh16", { { ParamType::Address, sizeof(UWORD_T) } }, OP_PUSH16_MEM },
+            { "psh32", { { ParamType::Address, sizeof(UWORD_T) } }, OP_PUSH32_MEM },
+            { "psh64", { { ParamType::Address, sizeof(UWORD_T) } }, OP_PUSH64_MEM },
+            { "psh", { { ParamType::Literal, 1 }, { ParamType::Address, sizeof(UWORD_T) } }, OP_PUSHN_MEM },
             { "psh", { { ParamType::Register, 1 } }, OP_PUSH_REG },
             { "psh8", { { ParamType::Register, 1 } }, OP_PUSH8_REG },
             { "psh16", { { ParamType::Register, 1 } }, OP_PUSH16_REG },
             { "psh32", { { ParamType::Register, 1 } }, OP_PUSH32_REG },
             { "psh64", { { ParamType::Register, 1 } }, OP_PUSH64_REG },
+            { "psh", { { ParamType::RegisterPointer, 1 } }, OP_PUSH_REGPTR },
+            { "psh8", { { ParamType::RegisterPointer, 1 } }, OP_PUSH8_REGPTR },
+            { "psh16", { { ParamType::RegisterPointer, 1 } }, OP_PUSH16_REGPTR },
+            { "psh32", { { ParamType::RegisterPointer, 1 } }, OP_PUSH32_REGPTR },
+            { "psh64", { { ParamType::RegisterPointer, 1 } }, OP_PUSH64_REGPTR },
+            { "psh", { { ParamType::Literal, 1 }, { ParamType::RegisterPointer, 1 } }, OP_PUSHN_REGPTR },
 
             { "pop", { { ParamType::Register, 1 } }, OP_POP_REG },
             { "pop8", { { ParamType::Register, 1 } }, OP_POP8_REG },
             { "pop16", { { ParamType::Register, 1 } }, OP_POP16_REG },
             { "pop32", { { ParamType::Register, 1 } }, OP_POP32_REG },
             { "pop64", { { ParamType::Register, 1 } }, OP_POP64_REG },
-            { "pop", { { ParamType::Literal, sizeof(WORD_T) }, { ParamType::Address, sizeof(UWORD_T) } }, OP_POPN_MEM },
+            { "pop", { { ParamType::Literal, 1 }, { ParamType::Address, sizeof(UWORD_T) } }, OP_POPN_MEM },
+            { "pop", { { ParamType::RegisterPointer, 1 } }, OP_POP_REGPTR },
+            { "pop8", { { ParamType::RegisterPointer, 1 } }, OP_POP8_REGPTR },
+            { "pop16", { { ParamType::RegisterPointer, 1 } }, OP_POP16_REGPTR },
+            { "pop32", { { ParamType::RegisterPointer, 1 } }, OP_POP32_REGPTR },
+            { "pop64", { { ParamType::RegisterPointer, 1 } }, OP_POP64_REGPTR },
+            { "pop", { { ParamType::Literal, 1 }, { ParamType::RegisterPointer, 1 } }, OP_POPN_REGPTR },
 
             { "cal", { { ParamType::Literal, sizeof(WORD_T) } }, OP_CALL_LIT },
             { "cal", { { ParamType::Register, 1 } }, OP_CALL_REG },
             { "syscall", { }, OP_SYSCALL },
+            { "ret", { }, OP_RET },
+
+            { "mcpy", { { ParamType::Register, 1 }, { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_MEMCPY },
+            { "mset", { { ParamType::Register, 1 }, { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_MEMSET },
+            { "mcmp", { { ParamType::Register, 1 }, { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_MEMCMP },
+            { "mchr", { { ParamType::Register, 1 }, { ParamType::Register, 1 }, { ParamType::Register, 1 } }, OP_MEMCHR },
     };
 }
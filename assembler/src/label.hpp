@@ -8,4 +8,17 @@ namespace assembler {
         int col;
         long long addr;
     };
+
+    /** A reference to a yet-undeclared label: argument `arg` of the instruction in chunk `chunk`. */
+    struct LabelFixup {
+        int chunk;
+        int arg;
+    };
+
+    /** An address in the image which must be patched when linking. */
+    struct Relocation {
+        int offset; // Byte offset of the value, relative to the start of the chunks
+        int size; // Byte size of the value
+        const std::string *label; // Label referenced, or nullptr if the value is already an offset into this file
+    };
 }
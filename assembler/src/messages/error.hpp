@@ -15,15 +15,12 @@ namespace message {
         CircularInclude,
         UnknownSection,
         SectionSeenBefore,
+        BadExpression,
     };
 
+    /** An error message. All state lives in Message, so errors may be stored by value as a Message. */
     class Error : public Message {
-    private:
-        ErrorType m_type;
-
     public:
         Error(std::filesystem::path file, int line, int col, ErrorType err);
-
-        int get_code() override { return (int) m_type; }
     };
 }
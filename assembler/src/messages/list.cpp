@@ -1,47 +1,72 @@
 #include "list.hpp"
 
+#include <algorithm>
+
 namespace message {
     void List::clear() {
-        for (auto message : messages) {
-            delete message;
-        }
-
         messages.clear();
-    }
-
-    bool List::has_message_of(Level level) {
-        return std::any_of(messages.begin(), messages.end(), [&level](Message *message) {
-            return message->get_level() == level;
-        });
+        std::fill(std::begin(counts), std::end(counts), 0);
+        suppressed = 0;
+        suppressing = false;
     }
 
     Message *List::get_message(Level level) {
-        auto it = std::find_if(messages.begin(), messages.end(), [&level](Message *message) {
-            return message->get_level() == level;
+        if (counts[level] == 0)
+            return nullptr;
+
+        auto it = std::find_if(messages.begin(), messages.end(), [&level](Message &message) {
+            return message.get_level() == level;
         });
 
-        return it == messages.end() ? nullptr : *it;
+        return it == messages.end() ? nullptr : &*it;
     }
 
-    void List::for_each_message(const std::function<void(Message&)>& func) const {
-        for (auto message : messages) {
-            func(*message);
+    void List::for_each_message(const std::function<void(Message&)>& func) {
+        for (auto &message : messages) {
+            func(message);
         }
     }
 
-    void List::for_each_message(const std::function<void(Message&)>& func, Level min_level) const {
-        for (auto message : messages) {
-            if (message->get_level() >= min_level) {
-                func(*message);
+    void List::for_each_message(const std::function<void(Message&)>& func, Level min_level) {
+        for (auto &message : messages) {
+            if (message.get_level() >= min_level) {
+                func(message);
             }
         }
     }
 
     void List::add(Message *message) {
-        messages.push_back(message);
+        add(std::move(*message));
+        delete message;
+    }
+
+    void List::add(Message message) {
+        Level level = message.get_level();
+        counts[level]++;
+
+        if (level == Level::Warning) {
+            suppressing = warning_limit != 0 && counts[level] > warning_limit;
+        } else if (level != Level::Note) {
+            suppressing = false;
+        }
+
+        if (suppressing) {
+            if (level == Level::Warning)
+                suppressed++;
+
+            return;
+        }
+
+        messages.push_back(std::move(message));
     }
 
     void List::append(List &other) {
-        messages.insert(messages.end(), other.messages.begin(), other.messages.end());
+        for (auto &message : other.messages) {
+            add(std::move(message));
+        }
+
+        counts[Level::Warning] += other.suppressed;
+        suppressed += other.suppressed;
+        other.clear();
     }
 }
@@ -7,29 +7,54 @@
 namespace message {
     class List {
     private:
-        std::vector<Message *> messages;
+        std::vector<Message> messages; // Messages, stored by value
+        size_t counts[Level::Error + 1] = { 0 }; // Number of messages added, per level
+        size_t warning_limit; // Maximum warnings to store, or 0 for no limit
+        size_t suppressed; // Number of warnings not stored due to <warning_limit>
+        bool suppressing; // Was the last warning suppressed? If so, suppress its notes, too.
 
     public:
+        List() {
+            warning_limit = 0;
+            suppressed = 0;
+            suppressing = false;
+        }
+
         /** Get number of messages. */
         size_t size() { return messages.size(); }
 
-        /** Clear messages (deletes every message). */
+        /** Clear messages. */
         void clear();
 
-        /** Add message. */
+        /** Add message. Takes ownership of <message>, which is moved into the list. */
         void add(Message *message);
 
+        /** Add message. */
+        void add(Message message);
+
         /** Return whether we contain a message of the given type. */
-        bool has_message_of(Level level);
+        bool has_message_of(Level level) const { return counts[level] > 0; }
+
+        /** Return whether we contain an error. */
+        bool has_errors() const { return counts[Level::Error] > 0; }
+
+        /** Get number of messages of the given type which have been added (including suppressed ones). */
+        size_t count(Level level) const { return counts[level]; }
+
+        /** Store at most <limit> warnings (0 = no limit). Further warnings, and their notes, are counted only. */
+        void set_warning_limit(size_t limit) { warning_limit = limit; }
+
+        /** Get number of warnings which were not stored due to the warning limit. */
+        size_t get_suppressed_count() const { return suppressed; }
 
         /** Get first message with the given level. */
         Message *get_message(Level level);
 
         /** Go through each message, calling the given function on it **/
-        void for_each_message(const std::function<void(Message&)>& func) const;
+        void for_each_message(const std::function<void(Message&)>& func);
 
         /** Go through each message, calling the given function on it. Only include messages which meet the minimum level. **/
-        void for_each_message(const std::function<void(Message&)>& func, Level min_level) const;
+        void for_each_message(const std::function<void(Message&)>& func, Level min_level);
 
         /** Merge given list into this (append). */
         void append(List &other);
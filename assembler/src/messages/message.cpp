@@ -11,6 +11,7 @@ namespace message {
         m_line = line;
         m_col = col;
         m_file = std::move(filename);
+        m_code = -1;
     }
 
     Message::Message(Level level, const assembler::pre_processor::LocationInformation& loc) {
@@ -18,6 +19,7 @@ namespace message {
         m_line = loc.line;
         m_col = loc.col;
         m_file = loc.file;
+        m_code = -1;
     }
 
     void Message::_set_message(std::string msg) {
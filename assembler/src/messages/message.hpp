@@ -24,7 +24,9 @@ namespace message {
         void print_type_suffix();
 
     protected:
-        virtual void _set_message(std::string msg);
+        int m_code; // Message code, or -1
+
+        void _set_message(std::string msg);
 
     public:
         Message(Level level, std::filesystem::path filename, int line, int col);
@@ -34,7 +36,7 @@ namespace message {
         std::string *get_message() { return &m_msg; }
 
         /** Get message code, or -1. */
-        virtual int get_code() { return -1; }
+        [[nodiscard]] int get_code() const { return m_code; }
 
         void set_message(const std::string& msg);
 
@@ -0,0 +1,80 @@
+#include "object_file.hpp"
+#include "binary_io.hpp"
+
+#include <fstream>
+
+namespace assembler::object {
+    using namespace binary_io;
+
+    /** Magic bytes at the start of an object file. */
+    static const char magic[4] = { 'C', 'V', 'M', 'O' };
+
+    void write(const Object &object, std::ostream &out) {
+        write_header(out, magic, version);
+        write_int(out, object.align);
+
+        write_int<uint64_t>(out, object.image.size());
+        out.write((const char *) object.image.data(), (std::streamsize) object.image.size());
+
+        write_int<uint32_t>(out, object.symbols.size());
+
+        for (const auto &symbol : object.symbols) {
+            write_string(out, symbol.name);
+            write_int(out, symbol.offset);
+        }
+
+        write_int<uint32_t>(out, object.relocations.size());
+
+        for (const auto &relocation : object.relocations) {
+            write_int(out, relocation.offset);
+            write_int(out, relocation.size);
+            write_string(out, relocation.symbol);
+        }
+    }
+
+    bool write(const Object &object, const std::filesystem::path &path) {
+        std::ofstream out(path, std::ios::binary);
+
+        if (!out.good())
+            return false;
+
+        write(object, out);
+        return out.good();
+    }
+
+    bool read(const std::filesystem::path &path, Object &object) {
+        std::ifstream in(path, std::ios::binary);
+        uint32_t count;
+        uint64_t size;
+
+        if (!read_header(in, magic, version) || !read_int(in, object.align) || object.align == 0 || !read_int(in, size))
+            return false;
+
+        object.image.resize(size);
+
+        if (!in.read((char *) object.image.data(), (std::streamsize) size) || !read_int(in, count))
+            return false;
+
+        object.symbols.resize(count);
+
+        for (auto &symbol : object.symbols) {
+            if (!read_string(in, symbol.name) || !read_int(in, symbol.offset))
+                return false;
+        }
+
+        if (!read_int(in, count))
+            return false;
+
+        object.relocations.resize(count);
+
+        for (auto &relocation : object.relocations) {
+            if (!read_int(in, relocation.offset) || !read_int(in, relocation.size) || !read_string(in, relocation.symbol))
+                return false;
+
+            if (relocation.size > sizeof(uint64_t) || relocation.offset + relocation.size > object.image.size())
+                return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** Object files, as produced by `assembler -c` and merged by `linker`.
+ * An object holds the encoded chunks of one source file (with no headers), the labels it declares and the locations of
+ * every label reference, so it may be placed at any offset in the final image. */
+namespace assembler::object {
+    /** Bump whenever the on-disk format changes. */
+    constexpr uint32_t version = 2;
+
+    /** Exported label. */
+    struct Symbol {
+        std::string name;
+        uint64_t offset; // Offset from start of the object's image
+    };
+
+    /** Value in the image to be patched: the address of <symbol>, or of the object's base if <symbol> is empty, is added
+     * to the <size>-byte value at <offset>. */
+    struct Relocation {
+        uint64_t offset;
+        uint8_t size;
+        std::string symbol;
+    };
+
+    struct Object {
+        uint32_t align = 1; // The object must be placed at a multiple of this, as its chunks were aligned relative to its start
+        std::vector<unsigned char> image;
+        std::vector<Symbol> symbols;
+        std::vector<Relocation> relocations;
+    };
+
+    /** Write object to the given stream. */
+    void write(const Object &object, std::ostream &out);
+
+    /** Write object to the given file. Return whether this was successful. */
+    bool write(const Object &object, const std::filesystem::path &path);
+
+    /** Read object from the given file. Return whether this was successful. */
+    bool read(const std::filesystem::path &path, Object &object);
+}
@@ -0,0 +1,691 @@
+#include "optimiser.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace assembler::optimiser {
+    /** Is this a jump whose only effect is to (maybe) move to its literal target? */
+    static bool is_plain_jump(OPCODE_T opcode) {
+        switch (opcode) {
+            case OP_JMP_LIT:
+            case OP_JMP_EQ_LIT:
+            case OP_JMP_GT_LIT:
+            case OP_JMP_GE_LIT:
+            case OP_JMP_LT_LIT:
+            case OP_JMP_LE_LIT:
+            case OP_JMP_NEQ_LIT:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /** Get the indices of chunks containing an expression. Their values may change as code moves, so are left alone. */
+    static std::unordered_set<int> get_expression_chunks(const Data &data) {
+        std::unordered_set<int> chunks;
+
+        for (const auto &expression : data.expressions)
+            chunks.insert(expression.chunk);
+
+        return chunks;
+    }
+
+    /** Get the index of the chunk containing the given address, or -1. An address in the padding before an aligned chunk
+     * belongs to that chunk. */
+    static long long find_chunk(const std::vector<Chunk> &chunks, long long address) {
+        auto it = std::upper_bound(chunks.begin(), chunks.end(), address, [](long long address, const Chunk &chunk) {
+            return address < chunk.get_offset();
+        });
+
+        if (it == chunks.begin())
+            return -1;
+
+        --it;
+
+        if (address < it->get_offset() + it->get_bytes())
+            return it - chunks.begin();
+
+        return it + 1 != chunks.end() ? it + 1 - chunks.begin() : -1;
+    }
+
+    /** Is a jump or call to a fixed address, or does an expression use `$`? If so, code cannot be moved. */
+    static bool has_fixed_addresses(const Data &data) {
+        std::unordered_set<int> relocated;
+
+        for (const auto &relocation : data.relocations)
+            relocated.insert(relocation.offset);
+
+        // Instruction arguments given by an expression, as (chunk, argument) pairs
+        std::unordered_set<long long> expression_args;
+
+        for (const auto &expression : data.expressions) {
+            for (const auto &token : expression.expression) {
+                if (token.type == expression::Token::Type::Here)
+                    return true;
+            }
+
+            expression_args.insert(((long long) expression.chunk << 32) | (unsigned int) expression.position);
+        }
+
+        for (size_t i = 0; i < data.chunks.size(); i++) {
+            const auto &chunk = data.chunks[i];
+
+            if (chunk.is_data())
+                continue;
+
+            // The target of a jump or call is its last argument
+            auto instruction = chunk.get_instruction();
+            auto opcode = instruction->signature->get_opcode();
+            int last = instruction->arg_count - 1;
+
+            if ((!instruction::is_jmp_opcode(opcode) && opcode != OP_CALL_LIT) || last < 0 ||
+                instruction->signature->get_param(last)->type != instruction::ParamType::Literal)
+                continue;
+
+            int offset = chunk.get_offset() + instruction->signature->get_bytes() - instruction->signature->get_param(last)->size;
+
+            if (relocated.find(offset) == relocated.end() && expression_args.find(((long long) i << 32) | (unsigned int) last) == expression_args.end())
+                return true;
+        }
+
+        return false;
+    }
+
+    /** Mark chunks which cannot be reached from the entry point as removed, using a control-flow graph: an instruction
+     * leads to the following chunk (unless control never returns from it) and to every address it refers to, and data
+     * leads to any data which follows it. Return how many there are. */
+    static int find_unreachable(const Data &data, std::vector<bool> &removed) {
+        const auto &chunks = data.chunks;
+
+        // Any label in an object file may be referred to by another file
+        if (chunks.empty() || data.object_file)
+            return 0;
+
+        std::vector<Relocation> relocations = data.relocations;
+        std::sort(relocations.begin(), relocations.end(), [](const auto &a, const auto &b) { return a.offset < b.offset; });
+
+        std::unordered_map<int, std::vector<const PendingExpression *>> expressions;
+
+        for (const auto &expression : data.expressions)
+            expressions[expression.chunk].push_back(&expression);
+
+        std::vector<bool> reachable(chunks.size());
+        std::vector<size_t> stack;
+
+        auto visit = [&](long long address) {
+            long long i = find_chunk(chunks, address);
+
+            if (i != -1 && !reachable[i]) {
+                reachable[i] = true;
+                stack.push_back((size_t) i);
+            }
+        };
+
+        auto entry = data.labels.find(data.main_label);
+        visit(entry == data.labels.end() ? (data.section_text == -1 ? 0 : data.section_text) : entry->second.addr);
+
+        while (!stack.empty()) {
+            size_t i = stack.back();
+            stack.pop_back();
+
+            const auto &chunk = chunks[i];
+            int start = chunk.get_offset(), end = start + chunk.get_bytes();
+
+            // Follow every label reference
+            auto relocation = std::lower_bound(relocations.begin(), relocations.end(), start, [](const auto &relocation, int offset) {
+                return relocation.offset < offset;
+            });
+
+            std::unordered_set<int> relocated;
+
+            for (; relocation != relocations.end() && relocation->offset < end; ++relocation) {
+                relocated.insert(relocation->offset);
+
+                if (chunk.is_data()) {
+                    unsigned long long value = 0;
+                    std::memcpy(&value, data.data_bytes.data() + chunk.get_data_start() + (relocation->offset - start), relocation->size);
+                    visit((long long) value);
+                }
+            }
+
+            // Follow every label in an expression
+            auto chunk_expressions = expressions.find((int) i);
+
+            if (chunk_expressions != expressions.end()) {
+                for (const auto *expression : chunk_expressions->second) {
+                    for (const auto &token : expression->expression) {
+                        if (token.type == expression::Token::Type::Label || token.type == expression::Token::Type::SizeOf) {
+                            auto label = data.labels.find(*token.label);
+
+                            if (label != data.labels.end())
+                                visit(label->second.addr);
+                        }
+                    }
+                }
+            }
+
+            if (chunk.is_data()) {
+                if (i + 1 < chunks.size() && chunks[i + 1].is_data())
+                    visit(chunks[i + 1].get_offset());
+
+                continue;
+            }
+
+            auto instruction = chunk.get_instruction();
+            auto signature = instruction->signature;
+            auto opcode = signature->get_opcode();
+            int offset = start + (int) sizeof(OPCODE_T);
+
+            for (int a = 0; a < instruction->arg_count; a++) {
+                if (relocated.find(offset) != relocated.end())
+                    visit((long long) instruction->args[a].get_data());
+
+                offset += signature->get_param(a)->size;
+            }
+
+            if (!instruction::is_terminator_opcode(opcode) && i + 1 < chunks.size())
+                visit(chunks[i + 1].get_offset());
+        }
+
+        int count = 0;
+
+        for (size_t i = 0; i < chunks.size(); i++) {
+            removed[i] = !reachable[i];
+            count += removed[i];
+        }
+
+        return count;
+    }
+
+    /** Remove labels of removed chunks, rather than moving them to the chunk which follows. */
+    static void remove_labels(Data &data, const std::vector<bool> &removed) {
+        // As a label may be redefined, keep any whose name is still referred to
+        std::unordered_set<std::string> referenced;
+
+        for (const auto &relocation : data.relocations) {
+            long long i = find_chunk(data.chunks, relocation.offset);
+
+            if (relocation.label && i != -1 && !removed[i])
+                referenced.insert(*relocation.label);
+        }
+
+        for (auto it = data.labels.begin(); it != data.labels.end();) {
+            long long i = find_chunk(data.chunks, it->second.addr);
+
+            if (i != -1 && removed[i] && referenced.find(it->first) == referenced.end()) {
+                it = data.labels.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /** Mark chunks with no effect as removed. Return how many there are. */
+    static int find_redundant(const Data &data, std::vector<bool> &removed) {
+        auto expression_chunks = get_expression_chunks(data);
+
+        // Addresses which may be jumped to
+        std::unordered_set<int> targets;
+
+        for (const auto &pair : data.labels)
+            targets.insert(pair.second.addr);
+
+        if (data.section_text != -1)
+            targets.insert(data.section_text);
+
+        int count = 0;
+        bool r0_known = false; // Do we know the value in r0?
+        unsigned long long r0 = 0;
+
+        for (size_t i = 0; i < data.chunks.size(); i++) {
+            const auto &chunk = data.chunks[i];
+
+            if (targets.find(chunk.get_offset()) != targets.end())
+                r0_known = false;
+
+            if (chunk.is_data()) {
+                r0_known = false;
+                continue;
+            }
+
+            auto instruction = chunk.get_instruction();
+            auto opcode = instruction->signature->get_opcode();
+            auto &args = instruction->args;
+
+            // Leave references to undeclared labels (object files) to the linker
+            if (std::any_of(args, args + instruction->arg_count, [](const auto &arg) { return arg.is_label(); }) ||
+                expression_chunks.find((int) i) != expression_chunks.end()) {
+                r0_known = false;
+                continue;
+            }
+
+            switch (opcode) {
+                case OP_MOV_REG_REG:
+                    removed[i] = args[0].get_data() == args[1].get_data();
+                    break;
+                case OP_ADD_REG_LIT:
+                case OP_SUB_REG_LIT:
+                    removed[i] = args[1].get_data() == 0;
+                    break;
+                case OP_MOV_LIT_REG:
+                    removed[i] = args[1].get_data() == 0 && r0_known && r0 == args[0].get_data();
+                    break;
+                default:
+                    removed[i] = is_plain_jump(opcode) && args[0].get_data() == chunk.get_offset() + chunk.get_bytes();
+            }
+
+            if (removed[i]) {
+                count++;
+                continue;
+            }
+
+            // Track r0 through instructions which are known to leave it alone (syscalls only read it)
+            if ((opcode == OP_MOV_LIT_REG || opcode == OP_MOV_REG_REG) && args[1].get_data() == 0) {
+                r0_known = opcode == OP_MOV_LIT_REG;
+                r0 = args[0].get_data();
+            } else if (opcode != OP_MOV_LIT_REG && opcode != OP_MOV_REG_REG && opcode != OP_SYSCALL && opcode != OP_NOP) {
+                r0_known = false;
+            }
+        }
+
+        return count;
+    }
+
+    /** Where the bytes of a removed data chunk may still be found: <offset> bytes into chunk <chunk>, or nowhere if -1. */
+    struct Alias {
+        int chunk;
+        int offset;
+    };
+
+    /** Lay out the chunks again: chunks marked in <removed> are dropped, and instructions with an entry in <encodings> take
+     * that signature. Each chunk is placed at a multiple of its alignment. Labels and every label reference are moved
+     * with them; those to a removed chunk with an entry in <aliases> are moved to its alias. */
+    static void relayout(Data &data, const std::vector<bool> &removed,
+                         const std::vector<instruction::Signature *> &encodings, const std::vector<Alias> &aliases = {}) {
+        auto &chunks = data.chunks;
+
+        size_t count = chunks.size();
+        std::vector<int> old_offsets(count + 1), new_offsets(count + 1);
+        int offset = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            old_offsets[i] = chunks[i].get_offset();
+
+            if (!removed[i]) {
+                int align = chunks[i].get_align();
+                offset = (offset + align - 1) / align * align;
+                new_offsets[i] = offset;
+                offset += encodings[i] ? encodings[i]->get_bytes() : chunks[i].get_bytes();
+            }
+        }
+
+        old_offsets[count] = count == 0 ? 0 : chunks.back().get_offset() + chunks.back().get_bytes();
+        new_offsets[count] = offset;
+
+        // A removed chunk's new offset is that of the chunk which follows it
+        for (size_t i = count; i-- > 0;) {
+            if (removed[i])
+                new_offsets[i] = new_offsets[i + 1];
+        }
+
+        // Index of the chunk containing the given (old) address, or <count> if beyond the end
+        auto find_chunk = [&](long long address) -> size_t {
+            auto it = std::upper_bound(old_offsets.begin(), old_offsets.end(), address);
+            return it == old_offsets.begin() ? 0 : it - old_offsets.begin() - 1;
+        };
+
+        // An address in the padding before an aligned chunk is moved to that chunk
+        auto move_address = [&](long long address) -> long long {
+            size_t i = find_chunk(address);
+
+            if (i < count && removed[i] && !aliases.empty() && aliases[i].chunk != -1)
+                return new_offsets[aliases[i].chunk] + aliases[i].offset + (address - old_offsets[i]);
+
+            if (i < count && (removed[i] || address >= old_offsets[i] + chunks[i].get_bytes()))
+                return new_offsets[i + 1];
+
+            return new_offsets[i] + (address - old_offsets[i]);
+        };
+
+        // Move every reference to a label in this file
+        std::vector<Relocation> relocations;
+
+        for (auto relocation : data.relocations) {
+            size_t i = find_chunk(relocation.offset);
+
+            if (i >= count || removed[i])
+                continue;
+
+            auto &chunk = chunks[i];
+            bool is_external = relocation.label && data.labels.find(*relocation.label) == data.labels.end();
+
+            if (chunk.is_data()) {
+                if (!is_external) {
+                    auto bytes = data.data_bytes.data() + chunk.get_data_start() + (relocation.offset - old_offsets[i]);
+                    unsigned long long value = 0;
+                    std::memcpy(&value, bytes, relocation.size);
+                    value = move_address((long long) value);
+                    std::memcpy(bytes, &value, relocation.size);
+                }
+
+                relocation.offset += new_offsets[i] - old_offsets[i];
+            } else {
+                auto instruction = chunk.get_instruction();
+                auto encoding = encodings[i] ? encodings[i] : instruction->signature;
+                int old_arg_offset = old_offsets[i] + (int) sizeof(OPCODE_T);
+                int new_arg_offset = new_offsets[i] + (int) sizeof(OPCODE_T);
+
+                for (int a = 0; a < instruction->arg_count; a++) {
+                    auto &arg = instruction->args[a];
+
+                    if (old_arg_offset == relocation.offset) {
+                        if (!is_external && !arg.is_label())
+                            arg.update(arg.get_type(), move_address((long long) arg.get_data()));
+
+                        relocation.offset = new_arg_offset;
+                        relocation.size = encoding->get_param(a)->size;
+                        break;
+                    }
+
+                    old_arg_offset += instruction->signature->get_param(a)->size;
+                    new_arg_offset += encoding->get_param(a)->size;
+                }
+            }
+
+            relocations.push_back(relocation);
+        }
+
+        data.relocations = std::move(relocations);
+
+        for (auto &pair : data.labels)
+            pair.second.addr = (int) move_address(pair.second.addr);
+
+        if (data.section_text != -1)
+            data.section_text = (int) move_address(data.section_text);
+
+        // Remove chunks, renumbering any pending label references
+        std::vector<int> new_index(count);
+        size_t kept = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            new_index[i] = (int) kept;
+
+            if (!removed[i]) {
+                chunks[i].set_offset(new_offsets[i]);
+
+                if (encodings[i])
+                    chunks[i].set_signature(encodings[i]);
+
+                chunks[kept++] = chunks[i];
+            }
+        }
+
+        chunks.erase(chunks.begin() + (long) kept, chunks.end());
+
+        for (auto &pair : data.label_fixups) {
+            for (auto &fixup : pair.second)
+                fixup.chunk = new_index[fixup.chunk];
+        }
+
+        data.expressions.erase(std::remove_if(data.expressions.begin(), data.expressions.end(), [&](const auto &expression) {
+            return removed[expression.chunk];
+        }), data.expressions.end());
+
+        for (auto &expression : data.expressions)
+            expression.chunk = new_index[expression.chunk];
+    }
+
+    /** Align each data chunk to the size of its items, so that they may be read from aligned addresses. */
+    static void align_data(Data &data) {
+        for (auto &chunk : data.chunks) {
+            if (chunk.is_data())
+                chunk.set_align(std::max(chunk.get_align(), chunk.get_item_bytes()));
+        }
+    }
+
+    /** Mark read-only data chunks whose bytes are the same as, or end, another's as removed, setting their entry in
+     * <aliases>. Data which holds a label reference or an expression, or is measured by sizeof, is left alone. Return how
+     * many there are. */
+    static int find_duplicates(Data &data, std::vector<bool> &removed, std::vector<Alias> &aliases) {
+        auto &chunks = data.chunks;
+        auto expression_chunks = get_expression_chunks(data);
+        std::unordered_set<int> relocated, measured;
+
+        for (const auto &relocation : data.relocations)
+            relocated.insert(relocation.offset);
+
+        for (const auto &expression : data.expressions) {
+            for (const auto &token : expression.expression) {
+                auto label = token.type == expression::Token::Type::SizeOf ? data.labels.find(*token.label) : data.labels.end();
+
+                if (label != data.labels.end())
+                    measured.insert(label->second.addr);
+            }
+        }
+
+        // Read-only data which may be shared
+        std::vector<size_t> candidates;
+
+        for (size_t i = 0; i < chunks.size(); i++) {
+            const auto &chunk = chunks[i];
+
+            if (!chunk.is_data() || !chunk.is_read_only() || chunk.get_bytes() == 0 ||
+                expression_chunks.find((int) i) != expression_chunks.end() ||
+                measured.find(chunk.get_offset()) != measured.end())
+                continue;
+
+            bool has_relocation = false;
+
+            for (int offset = chunk.get_offset(); offset < chunk.get_offset() + chunk.get_bytes() && !has_relocation; offset++)
+                has_relocation = relocated.find(offset) != relocated.end();
+
+            if (!has_relocation)
+                candidates.push_back(i);
+        }
+
+        auto begin = [&](size_t i) { return data.data_bytes.begin() + (long) chunks[i].get_data_start(); };
+        auto end = [&](size_t i) { return begin(i) + chunks[i].get_bytes(); };
+
+        // Sort by reversed bytes: a chunk which ends another is then followed by the chunks it ends
+        std::stable_sort(candidates.begin(), candidates.end(), [&](size_t a, size_t b) {
+            return std::lexicographical_compare(std::make_reverse_iterator(end(a)), std::make_reverse_iterator(begin(a)),
+                                                std::make_reverse_iterator(end(b)), std::make_reverse_iterator(begin(b)));
+        });
+
+        int count = 0;
+        size_t root = candidates.empty() ? 0 : candidates.back(); // Longest chunk which the current one ends
+
+        for (size_t c = candidates.size(); c-- > 1;) {
+            size_t i = candidates[c - 1];
+            int offset = chunks[root].get_bytes() - chunks[i].get_bytes();
+            bool is_suffix = offset >= 0 && std::equal(std::make_reverse_iterator(end(i)), std::make_reverse_iterator(begin(i)),
+                                                       std::make_reverse_iterator(end(root)));
+
+            if (!is_suffix) {
+                root = i;
+                continue;
+            }
+
+            // Our bytes must be as aligned within the other chunk as they are now
+            if (offset % chunks[i].get_align() != 0) {
+                root = i;
+                continue;
+            }
+
+            chunks[root].set_align(std::max(chunks[root].get_align(), chunks[i].get_align()));
+            removed[i] = true;
+            aliases[i] = { (int) root, offset };
+            count++;
+        }
+
+        return count;
+    }
+
+    /** Get the signature moving a literal of the given byte-size to a register. */
+    static instruction::Signature *get_mov_lit_reg(int size) {
+        switch (size) {
+            case 1:
+                return instruction::Signature::find(OP_MOV8_LIT_REG);
+            case 2:
+                return instruction::Signature::find(OP_MOV16_LIT_REG);
+            case 4:
+                return instruction::Signature::find(OP_MOV32_LIT_REG);
+            default:
+                return instruction::Signature::find(OP_MOV_LIT_REG);
+        }
+    }
+
+    /** Choose a smaller encoding for the instruction in <chunk> given the current layout, or return nullptr.
+     * <is_relocated> is whether its literal argument refers to a label. Distances may grow by up to <slack> bytes. */
+    static instruction::Signature *find_smaller_encoding(const Data &data, const Chunk &chunk, bool is_relocated, int slack) {
+        auto instruction = chunk.get_instruction();
+        auto signature = instruction->signature;
+        auto opcode = signature->get_opcode();
+        auto value = instruction->args[0].get_data();
+
+        switch (opcode) {
+            case OP_MOV_LIT_REG:
+            case OP_MOV32_LIT_REG:
+            case OP_MOV16_LIT_REG: {
+                // Addresses in an object file are changed by the linker, so must keep their size
+                if (is_relocated && data.object_file)
+                    return nullptr;
+
+                // The literal is zero-extended into the register
+                int size = value <= UINT8_MAX ? 1 : value <= UINT16_MAX ? 2 : value <= UINT32_MAX ? 4 : 8;
+                auto encoding = get_mov_lit_reg(size);
+                return encoding->get_bytes() < signature->get_bytes() ? encoding : nullptr;
+            }
+            default:
+                break;
+        }
+
+        // A jump may be made relative to the following instruction, unless it is to a fixed address and we may be moved
+        if (!is_relocated && data.object_file)
+            return nullptr;
+
+        for (int size : { 2, 4 }) {
+            auto relative = instruction::get_relative_jmp_opcode(opcode, size);
+
+            if (relative == 0)
+                return nullptr;
+
+            auto encoding = instruction::Signature::find(relative);
+
+            if (encoding == nullptr || encoding->get_bytes() >= signature->get_bytes())
+                return nullptr;
+
+            long long offset = (long long) value - (chunk.get_offset() + encoding->get_bytes());
+            long long limit = 1LL << (size * 8 - 1);
+
+            if (offset >= -limit + slack && offset < limit - slack)
+                return encoding;
+        }
+
+        return nullptr;
+    }
+
+    /** Shrink instructions until no more can be shrunk. This brings addresses closer together, except that the padding
+     * before aligned chunks may grow, by less than the largest alignment in all (as alignments are powers of two), so
+     * offsets are chosen to fit even then. Any offset which fitted into an encoding will continue to. Finally, relative
+     * jumps are given their offsets. */
+    static void relax(Data &data) {
+        auto &chunks = data.chunks;
+        std::vector<bool> removed(chunks.size());
+        auto expression_chunks = get_expression_chunks(data);
+        int slack = 0;
+
+        for (const auto &chunk : chunks)
+            slack = std::max(slack, chunk.get_align() - 1);
+
+        while (true) {
+            std::unordered_set<int> relocated; // Offsets of values which refer to a label
+
+            for (const auto &relocation : data.relocations)
+                relocated.insert(relocation.offset);
+
+            std::vector<instruction::Signature *> encodings(chunks.size());
+            bool changed = false;
+
+            for (size_t i = 0; i < chunks.size(); i++) {
+                const auto &chunk = chunks[i];
+
+                if (chunk.is_data() || expression_chunks.find((int) i) != expression_chunks.end())
+                    continue;
+
+                auto instruction = chunk.get_instruction();
+
+                if (std::any_of(instruction->args, instruction->args + instruction->arg_count, [](const auto &arg) { return arg.is_label(); }))
+                    continue;
+
+                bool is_relocated = relocated.find(chunk.get_offset() + (int) sizeof(OPCODE_T)) != relocated.end();
+                encodings[i] = find_smaller_encoding(data, chunk, is_relocated, slack);
+                changed |= encodings[i] != nullptr;
+            }
+
+            if (!changed)
+                break;
+
+            relayout(data, removed, encodings);
+        }
+
+        // Relative jumps are position-independent, so no longer need relocating
+        std::unordered_set<int> relative;
+
+        for (auto &chunk : chunks) {
+            if (chunk.is_data())
+                continue;
+
+            auto instruction = chunk.get_instruction();
+
+            if (instruction->arg_count > 0 && instruction->signature->get_param(0)->type == instruction::ParamType::Relative) {
+                auto &arg = instruction->args[0];
+                arg.update(arg.get_type(), arg.get_data() - (chunk.get_offset() + chunk.get_bytes()));
+                relative.insert(chunk.get_offset() + (int) sizeof(OPCODE_T));
+            }
+        }
+
+        data.relocations.erase(std::remove_if(data.relocations.begin(), data.relocations.end(), [&](const auto &relocation) {
+            return relative.find(relocation.offset) != relative.end();
+        }), data.relocations.end());
+    }
+
+    /** Get the byte-size of the assembled chunks. */
+    static int get_size(const Data &data) {
+        return data.chunks.empty() ? 0 : data.chunks.back().get_offset() + data.chunks.back().get_bytes();
+    }
+
+    int optimise(Data &data) {
+        int size = get_size(data);
+        std::vector<bool> removed(data.chunks.size());
+
+        // Everything below moves code
+        if (has_fixed_addresses(data))
+            return 0;
+
+        // Nothing refers to unreachable chunks, so nor to their labels
+        if (find_unreachable(data, removed) > 0) {
+            remove_labels(data, removed);
+            relayout(data, removed, std::vector<instruction::Signature *>(data.chunks.size()));
+        }
+
+        // Lay out data again, aligned and with duplicates shared
+        align_data(data);
+        removed.assign(data.chunks.size(), false);
+        std::vector<Alias> aliases(data.chunks.size(), { -1, 0 });
+        find_duplicates(data, removed, aliases);
+        relayout(data, removed, std::vector<instruction::Signature *>(data.chunks.size()), aliases);
+
+        removed.assign(data.chunks.size(), false);
+
+        if (find_redundant(data, removed) > 0)
+            relayout(data, removed, std::vector<instruction::Signature *>(data.chunks.size()));
+
+        relax(data);
+
+        return size - get_size(data);
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "assembler_data.hpp"
+
+/** Optimiser (`-O`), run over the chunks once parsed. First, chunks which cannot be reached from the entry point are
+ * removed, by following control flow and label references. Data is then aligned to the size of its items, and read-only
+ * data which repeats, or ends, other read-only data shares its bytes. Then, instructions which have no effect are removed:
+ *   - `mov rX, rX`
+ *   - `add r, 0` and `sub r, 0`
+ *   - A jump to the following instruction
+ *   - `mov lit, r0` when r0 is known to already hold `lit` (e.g., consecutive syscalls)
+ * The remaining chunks are then laid out again, moving labels and every label reference with them.
+ * Code is assumed to only be jumped to via labels, so nothing is known about registers at a label.
+ * Then, instructions are given shorter encodings where possible (branch relaxation):
+ *   - `mov lit, reg` uses the smallest of `mov8`/`mov16`/`mov32` which holds the literal
+ *   - Literal jumps become relative to the following instruction, with a 16- or 32-bit offset
+ * In an object file, references to labels keep their full size, as the linker may move them.
+ * Instructions containing expressions are left as they are, and expressions must be evaluated again afterwards. */
+namespace assembler::optimiser {
+    /** Optimise the chunks in <data>, which must record relocations. Return the number of bytes saved. */
+    int optimise(Data &data);
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <functional>
 
@@ -9,7 +10,9 @@ extern "C" {
 }
 
 namespace assembler::parser {
-    std::unordered_set<std::string> valid_sections = { "text", "data" };
+    std::unordered_set<std::string> valid_sections = { "text", "data", "rodata" };
+
+    static int get_type_size(const std::string &type);
 
     void parse(Data &data, message::List &msgs) {
         // Keep track of encountered sections (section -> line)
@@ -21,6 +24,29 @@ namespace assembler::parser {
         // Current section
         std::string current_section = "text";
 
+        // Alignment of the next chunk, from `.align`
+        int align = 1;
+
+        // Labels declared since the last chunk. These belong to the next chunk, so are moved by `.align`, and earlier
+        // references to them are only filled in once it exists
+        std::vector<std::string> pending_labels;
+
+        auto place_labels = [&]() {
+            for (const auto &name : pending_labels)
+                data.replace_label(name, (int) data.labels[name].addr);
+
+            pending_labels.clear();
+        };
+
+        auto align_chunk = [&]() {
+            data.chunks.back().set_align(align);
+            align = 1;
+            place_labels();
+        };
+
+        // At most one chunk is produced per line
+        data.chunks.reserve(data.chunks.size() + data.lines.size());
+
         for (int line_idx = 0; line_idx < data.lines.size(); line_idx++) {
             const auto &line = data.lines[line_idx];
 
@@ -89,6 +115,47 @@ namespace assembler::parser {
                 continue;
             }
 
+            // Align the next chunk (and any labels before it)
+            if (starts_with(line.data, ".align")) {
+                skip_whitespace(line.data, i);
+                int j = i;
+                skip_non_whitespace(line.data, i);
+                std::string argument = line.data.substr(j, i - j);
+
+                unsigned long long n;
+                double _1;
+                bool is_decimal;
+
+                if (!parse_number(argument, is_decimal, n, _1) || is_decimal || n == 0 || n > 4096 || (n & (n - 1)) != 0) {
+                    auto error = new class message::Error(data.file_path, line.n, j, message::ErrorType::Syntax);
+                    error->set_message("Expected a power of two up to 4096 after .align, got '" + argument + "'");
+                    msgs.add(error);
+                    return;
+                }
+
+                // Must be EOL
+                skip_whitespace(line.data, i);
+                if (i != line.data.size()) {
+                    std::string ch(1, line.data[i]);
+
+                    auto error = new class message::Error(data.file_path, line.n, i, message::ErrorType::Syntax);
+                    error->set_message("Expected end-of-line after .align, got '" + ch + "'");
+                    msgs.add(error);
+                    return;
+                }
+
+                align = std::max(align, (int) n);
+                offset = (offset + align - 1) / align * align;
+
+                for (const auto &name : pending_labels)
+                    data.labels[name].addr = offset;
+
+                if (data.debug)
+                    std::cout << "[" << line.n << ":" << j << "] .align " << n << " to offset +" << offset << "\n";
+
+                continue;
+            }
+
             // Do we have a label?
             if (line.data[i - 1] == ':') {
                 std::string label_name = line.data.substr(start, i - 1);
@@ -138,8 +205,8 @@ namespace assembler::parser {
                     label->second.addr = offset;
                 }
 
-                // Replace all past references with its address
-                data.replace_label(label_name, offset);
+                // Past references are replaced with its address once it is placed
+                pending_labels.push_back(label_name);
 
                 // End of input?
                 if (i == line.data.size()) {
@@ -158,36 +225,61 @@ namespace assembler::parser {
                 std::cout << "[" << line_idx << ":" << start << "] Mnemonic " << mnemonic << "\n";
 
             // .section DATA
-            if (!data.strict_sections || current_section == "data") {
-                // Is constant specifier?
-                std::vector<unsigned char> *bytes = nullptr;
+            if (!data.strict_sections || current_section == "data" || current_section == "rodata") {
+                // Is constant specifier? Its bytes are appended to the data arena.
+                size_t data_start = data.data_bytes.size(), relocation_start = data.relocations.size();
+
+                if (parse_data(data, line_idx, start, msgs, data.data_bytes, data.records_relocations() ? &data.relocations : nullptr)) {
+                    int bytes = (int) (data.data_bytes.size() - data_start);
+
+                    // Relocations were recorded relative to the data arena
+                    for (size_t r = relocation_start; r < data.relocations.size(); r++) {
+                        data.relocations[r].offset += offset - (int) data_start;
+                    }
 
-                if (parse_data(data, line_idx, start, msgs, &bytes)) {
                     if (data.debug)
-                        std::cout << "\tData (" << bytes->size() << " bytes)\n";
+                        std::cout << "\tData (" << bytes << " bytes)\n";
 
                     // Check for errors
-                    if (msgs.has_message_of(message::Level::Error)) {
-                        delete bytes;
+                    if (msgs.has_errors()) {
                         return;
                     }
 
                     // Insert into a Chunk
-                    auto chunk = new Chunk(line_idx, offset);
-                    chunk->set_data(bytes);
-                    offset += chunk->get_bytes();
-                    data.chunks.push_back(chunk);
+                    data.chunks.emplace_back(line_idx, offset, data_start, bytes);
+                    data.chunks.back().set_item_bytes(get_type_size(mnemonic));
+                    data.chunks.back().set_read_only(current_section == "rodata");
+                    align_chunk();
+                    offset += bytes;
 
                     continue;
                 } else if (data.strict_sections) {
                     auto err = new class message::Error(data.file_path, line.n, start, message::ErrorType::UnknownMnemonic);
-                    err->set_message("Unknown data-type '" + mnemonic + "' (.section data)");
+                    err->set_message("Unknown data-type '" + mnemonic + "' (.section " + current_section + ")");
                     msgs.add(err);
                     return;
                 }
             }
 
             // .section TEXT
+            // Has this text been parsed before? Parsing only depends on the text, as labels are resolved afterwards
+            std::string text;
+
+            if (data.incremental) {
+                text = line.data.substr(start);
+                auto cached = data.instruction_cache.find(text);
+
+                if (cached != data.instruction_cache.end()) {
+                    cached->second.used = true;
+                    data.chunks.emplace_back(line_idx, offset, cached->second.instruction);
+                    align_chunk();
+                    data.add_label_fixups((int) data.chunks.size() - 1);
+                    offset += data.chunks.back().get_bytes();
+
+                    continue;
+                }
+            }
+
             // Before anything, check if mnemonic exists
             if (!instruction::Signature::exists(mnemonic)) {
                 auto err = new class message::Error(data.file_path, line.n, start, message::ErrorType::UnknownMnemonic);
@@ -199,13 +291,16 @@ namespace assembler::parser {
             // Parse arguments
             std::vector<instruction::Argument> arguments;
             std::vector<instruction::ArgumentType> argument_types;
+            std::vector<PendingExpression> expressions;
 
             while (i < line.data.size()) {
                 skip_whitespace(line.data, i);
 
                 // Parse argument
                 instruction::Argument argument;
-                parse_arg(data, line_idx, i, msgs, argument);
+                expression::Expression expression;
+                int arg_start = i;
+                parse_arg(data, line_idx, i, msgs, argument, expression);
 
                 // Must end in break character
                 if (i < line.data.size() && line.data[i] != ' ' && line.data[i] != ',') {
@@ -217,7 +312,7 @@ namespace assembler::parser {
                 }
 
                 // Tell user which argument it was
-                if (msgs.has_message_of(message::Level::Error)) {
+                if (msgs.has_errors()) {
                     auto msg = new message::Message(message::Level::Note, data.file_path, line.n, 0);
                     msg->set_message("While parsing mnemonic " + mnemonic + " argument #" + std::to_string(arguments.size() + 1));
                     msgs.add(msg);
@@ -225,6 +320,10 @@ namespace assembler::parser {
                     return;
                 }
 
+                // Its value is filled in once labels have been laid out
+                if (!expression.empty())
+                    expressions.push_back({ -1, (int) arguments.size(), 0, false, arg_start, std::move(expression), {} });
+
                 // Add to argument list
                 arguments.push_back(argument);
                 argument_types.push_back(argument.get_type());
@@ -261,84 +360,104 @@ namespace assembler::parser {
                 return;
             }
 
-            // Build instruction
-            auto instruction = new instruction::Instruction(*signature, arguments);
+            // Build instruction, and insert into a Chunk. Expressions depend on more than the text, so are not cached.
+            instruction::Instruction instruction(*signature, arguments);
+
+            if (data.incremental && expressions.empty())
+                data.instruction_cache.insert({ std::move(text), { instruction, true } });
 
-            // Insert into a Chunk
-            auto chunk = new Chunk(line_idx, offset);
-            chunk->set_instruction(instruction);
+            for (auto &expression : expressions) {
+                expression.chunk = (int) data.chunks.size();
+                data.expressions.push_back(std::move(expression));
+            }
 
-            data.chunks.push_back(chunk);
-            offset += chunk->get_bytes();
+            data.chunks.emplace_back(line_idx, offset, instruction);
+            align_chunk();
+            data.add_label_fixups((int) data.chunks.size() - 1);
+            offset += data.chunks.back().get_bytes();
         }
 
-        // Check if any labels left...
-        for (auto chunk : data.chunks) {
-            if (!chunk->is_data()) {
-                auto instruction = chunk->get_instruction();
+        place_labels();
 
-                for (auto & arg : instruction->args) {
-                    if (arg.is_label()) {
-                        auto line = data.lines[chunk->get_source_line()];
+        // Any references left are to labels which were never declared (object files leave these to the linker)
+        if (!data.label_fixups.empty() && !data.object_file) {
+            std::vector<LabelFixup> unresolved;
 
-                        auto err = new class message::Error(data.file_path, line.n, 0, message::ErrorType::UnknownLabel);
-                        err->set_message("Unresolved label reference '" + *arg.get_label() + "'");
-                        msgs.add(err);
-                        return;
-                    }
-                }
+            for (const auto &pair : data.label_fixups) {
+                unresolved.insert(unresolved.end(), pair.second.begin(), pair.second.end());
+            }
+
+            std::sort(unresolved.begin(), unresolved.end(), [](const LabelFixup &a, const LabelFixup &b) {
+                return a.chunk < b.chunk || (a.chunk == b.chunk && a.arg < b.arg);
+            });
+
+            for (const auto &fixup : unresolved) {
+                auto &chunk = data.chunks[fixup.chunk];
+                auto &line = data.lines[chunk.get_source_line()];
+
+                auto err = new class message::Error(data.file_path, line.n, 0, message::ErrorType::UnknownLabel);
+                err->set_message("Unresolved label reference '" + *chunk.get_instruction()->args[fixup.arg].get_label() + "'");
+                msgs.add(err);
             }
         }
+
+        if (!msgs.has_errors())
+            data.evaluate_expressions(msgs);
     }
 
-    /** Add byte sequence to new vector, cast all to integers (type #1). */
+    /** Append byte sequence to <bytes>, cast all to integers (type #1). */
     template<typename T>
-    std::vector<unsigned char>* add_byte_sequence(const Data &data, int line_idx, int &col, message::List &msgs) {
-        auto bytes = new std::vector<unsigned char>();
+    void add_byte_sequence(Data &data, int line_idx, int &col, message::List &msgs, std::vector<unsigned char> &bytes,
+                           std::vector<Relocation> *relocations) {
+        size_t start = bytes.size();
 
-        parse_byte_sequence(data, line_idx, col, msgs, [bytes](long long v_int, double v_dbl, bool is_dbl) {
+        parse_byte_sequence(data, line_idx, col, msgs, [&bytes, relocations](long long v_int, double v_dbl, bool is_dbl, bool is_label) {
             T value = static_cast<T>(v_int);
 
+            if (is_label && relocations)
+                relocations->push_back({ (int) bytes.size(), (int) sizeof(T), nullptr });
+
             for (int i = 0; i < sizeof(T); i++) {
-                bytes->push_back((value >> (i * 8)) & 0xFF);
+                bytes.push_back((value >> (i * 8)) & 0xFF);
             }
+        }, [&](int item_col, expression::Expression &&expression) {
+            data.expressions.push_back({ (int) data.chunks.size(), (int) (bytes.size() - start), (int) sizeof(T), false,
+                                         item_col, std::move(expression), {} });
+            bytes.insert(bytes.end(), sizeof(T), 0);
         });
 
         // If empty, add 0
-        if (bytes->empty()) {
-            for (int i = 0; i < sizeof(T); i++) {
-                bytes->push_back(0);
-            }
+        if (bytes.size() == start) {
+            bytes.insert(bytes.end(), sizeof(T), 0);
         }
-
-        return bytes;
     }
 
-    /** Add byte sequence to new vector, cast all to floats (type #1), store an type #2 (int type of same size). */
+    /** Append byte sequence to <bytes>, cast all to floats (type #1), store an type #2 (int type of same size). */
     template<typename T, typename S>
-    std::vector<unsigned char>* add_byte_sequence_float(const Data &data, int line_idx, int &col, message::List &msgs) {
-        auto bytes = new std::vector<unsigned char>();
+    void add_byte_sequence_float(Data &data, int line_idx, int &col, message::List &msgs, std::vector<unsigned char> &bytes) {
+        size_t start = bytes.size();
 
-        parse_byte_sequence(data, line_idx, col, msgs, [bytes](long long v_int, double v_dbl, bool is_dbl) {
+        parse_byte_sequence(data, line_idx, col, msgs, [&bytes](long long v_int, double v_dbl, bool is_dbl, bool is_label) {
             T intermediate = static_cast<T>(is_dbl ? v_dbl : v_int);
             S value = *(S *) &intermediate;
 
             for (int i = 0; i < sizeof(S); i++) {
-                bytes->push_back((value >> (i * 8)) & 0xFF);
+                bytes.push_back((value >> (i * 8)) & 0xFF);
             }
+        }, [&](int item_col, expression::Expression &&expression) {
+            data.expressions.push_back({ (int) data.chunks.size(), (int) (bytes.size() - start), (int) sizeof(S), true,
+                                         item_col, std::move(expression), {} });
+            bytes.insert(bytes.end(), sizeof(S), 0);
         });
 
         // If empty, add 0
-        if (bytes->empty()) {
-            for (int i = 0; i < sizeof(S); i++) {
-                bytes->push_back(0);
-            }
+        if (bytes.size() == start) {
+            bytes.insert(bytes.end(), sizeof(S), 0);
         }
-
-        return bytes;
     }
 
-    bool parse_data(const Data &data, int line_idx, int &col, message::List &msgs, std::vector<unsigned char> **bytes) {
+    bool parse_data(Data &data, int line_idx, int &col, message::List &msgs, std::vector<unsigned char> &bytes,
+                    std::vector<Relocation> *relocations) {
         auto& line = data.lines[line_idx];
 
         // Extract datatype
@@ -346,57 +465,53 @@ namespace assembler::parser {
         skip_non_whitespace(line.data, col);
         std::string datatype = line.data.substr(start, col - start);
 
-        std::function<void(unsigned char)> add_byte = [bytes](unsigned char byte) {
-            (*bytes)->push_back(byte);
-        };
-
         if (datatype == "u8") {
-            *bytes = add_byte_sequence<uint8_t>(data, line_idx, col, msgs);
+            add_byte_sequence<uint8_t>(data, line_idx, col, msgs, bytes, relocations);
             return true;
         }
 
         if (datatype == "i8") {
-            *bytes = add_byte_sequence<int8_t>(data, line_idx, col, msgs);
+            add_byte_sequence<int8_t>(data, line_idx, col, msgs, bytes, relocations);
             return true;
         }
 
         if (datatype == "u16") {
-            *bytes = add_byte_sequence<uint16_t>(data, line_idx, col, msgs);
+            add_byte_sequence<uint16_t>(data, line_idx, col, msgs, bytes, relocations);
             return true;
         }
 
         if (datatype == "i16") {
-            *bytes = add_byte_sequence<int16_t>(data, line_idx, col, msgs);
+            add_byte_sequence<int16_t>(data, line_idx, col, msgs, bytes, relocations);
             return true;
         }
 
         if (datatype == "u32") {
-            *bytes = add_byte_sequence<uint32_t>(data, line_idx, col, msgs);
+            add_byte_sequence<uint32_t>(data, line_idx, col, msgs, bytes, relocations);
             return true;
         }
 
         if (datatype == "i32") {
-            *bytes = add_byte_sequence<int32_t>(data, line_idx, col, msgs);
+            add_byte_sequence<int32_t>(data, line_idx, col, msgs, bytes, relocations);
             return true;
         }
 
         if (datatype == "u64") {
-            *bytes = add_byte_sequence<uint64_t>(data, line_idx, col, msgs);
+            add_byte_sequence<uint64_t>(data, line_idx, col, msgs, bytes, relocations);
             return true;
         }
 
         if (datatype == "i64") {
-            *bytes = add_byte_sequence<int64_t>(data, line_idx, col, msgs);
+            add_byte_sequence<int64_t>(data, line_idx, col, msgs, bytes, relocations);
             return true;
         }
 
         if (datatype == "f32") {
-            *bytes = add_byte_sequence_float<float, uint32_t>(data, line_idx, col, msgs);
+            add_byte_sequence_float<float, uint32_t>(data, line_idx, col, msgs, bytes);
             return true;
         }
 
         if (datatype == "f64") {
-            *bytes = add_byte_sequence_float<double, uint64_t>(data, line_idx, col, msgs);
+            add_byte_sequence_float<double, uint64_t>(data, line_idx, col, msgs, bytes);
             return true;
         }
 
@@ -404,15 +519,18 @@ namespace assembler::parser {
         return false;
     }
 
-    void parse_arg(const Data &data, int line_idx, int &col, message::List &msgs, instruction::Argument &argument) {
-        auto line = data.lines[line_idx];
+    void parse_arg(Data &data, int line_idx, int &col, message::List &msgs, instruction::Argument &argument,
+                   expression::Expression &expression) {
+        auto &line = data.lines[line_idx];
+
+        bool is_expr = is_expression(line.data, col, true);
 
-        if (line.data[col] == '\'') { // Character Literal
+        if (line.data[col] == '\'' && !is_expr) { // Character Literal
             unsigned long long value;
             parse_character_literal(data, line_idx, ++col, msgs, value);
 
             // Any errors?
-            if (msgs.has_message_of(message::Level::Error)) {
+            if (msgs.has_errors()) {
                 return;
             }
 
@@ -423,11 +541,24 @@ namespace assembler::parser {
 
         if (line.data[col] == '[') { // Address, register pointer, label (addr)
             int start = ++col;
-            parse_arg_lit(data, line_idx, col, msgs, argument);
+            parse_arg_lit(data, line_idx, col, msgs, argument, expression);
 
-            if (msgs.has_message_of(message::Level::Error))
+            if (msgs.has_errors())
                 return;
 
+            // Indexed operand, "[base + index*scale + disp]"?
+            if (start < col && argument.get_type() == instruction::ArgumentType::Register) {
+                int j = col;
+                skip_whitespace(line.data, j);
+
+                if (line.data[j] == '+' || line.data[j] == '-') {
+                    parse_arg_indexed(data, line_idx, col, msgs, argument);
+
+                    if (msgs.has_errors())
+                        return;
+                }
+            }
+
             // Check if something was parsed
             if (start < col) {
                 // Must end with a closing bracket
@@ -448,17 +579,19 @@ namespace assembler::parser {
                 col++;
 
                 // Transform argument datatype
-                argument.transform_address_equivalent();
+                if (argument.get_type() != instruction::ArgumentType::Indexed)
+                    argument.transform_address_equivalent();
 
                 return;
             }
         }
 
-        if (line.data[col] == '+' || line.data[col] == '-' || std::isalnum(line.data[col])) { // Numeric literal, register, label (lit)
+        if (line.data[col] == '+' || line.data[col] == '-' || std::isalnum(line.data[col]) || line.data[col] == '_' ||
+            line.data[col] == '(' || line.data[col] == '$' || line.data[col] == '~' || is_expr) { // Numeric literal, register, label (lit), expression
             int start = col;
-            parse_arg_lit(data, line_idx, col, msgs, argument);
+            parse_arg_lit(data, line_idx, col, msgs, argument, expression);
 
-            if (msgs.has_message_of(message::Level::Error))
+            if (msgs.has_errors())
                 return;
 
             // Check if something was parsed
@@ -475,7 +608,8 @@ namespace assembler::parser {
         msgs.add(err);
     }
 
-    void parse_arg_lit(const Data &data, int line_idx, int &col, message::List &msgs, instruction::Argument &argument) {
+    void parse_arg_lit(Data &data, int line_idx, int &col, message::List &msgs, instruction::Argument &argument,
+                       expression::Expression &expression) {
         auto& line = data.lines[line_idx];
 
         // Extract characters
@@ -493,6 +627,14 @@ namespace assembler::parser {
             return;
         }
 
+        // Is expression? Its value is filled in later. Arguments are separated by commas, so may contain spaces.
+        if (is_expression(line.data, start, true)) {
+            col = start;
+            parse_expression(data, line_idx, col, msgs, expression, true);
+            argument.update(instruction::ArgumentType::Literal, 0);
+            return;
+        }
+
         // Parse as number
         unsigned long long number;
         double _1;
@@ -503,25 +645,350 @@ namespace assembler::parser {
             return;
         }
 
-        // Must be a label, then
-        auto label = data.labels.find(sub);
+        // Must be a label, then. Check if name is valid - if not, report generic syntax error (not label error)
+        if (!is_valid_label_name(sub)) {
+            auto err = new class message::Error(data.file_path, line.n, col, message::ErrorType::Syntax);
+            err->set_message("Syntax Error: '" + sub + "'");
+            msgs.add(err);
+            return;
+        }
 
-        // New label?
-        if (label == data.labels.end()) {
-            // Check if name is valid - if not, report generic syntax error (not label error)
-            if (!is_valid_label_name(sub)) {
+        // Its value is substituted once the instruction's chunk exists (see Data::add_label_fixups)
+        argument.update(instruction::ArgumentType::LabelLiteral, 0);
+        argument.set_label(data.intern_label(sub));
+    }
+
+    void parse_arg_indexed(const Data &data, int line_idx, int &col, message::List &msgs, instruction::Argument &argument) {
+        auto& line = data.lines[line_idx];
+        int base = (int) argument.get_data(), index = 0, scale = 0;
+        long long disp = 0;
+
+        while (true) {
+            skip_whitespace(line.data, col);
+
+            if (col >= line.data.size() || line.data[col] == ']')
+                break;
+
+            // Each term is preceded by a sign
+            char sign = line.data[col];
+
+            if (sign != '+' && sign != '-') {
                 auto err = new class message::Error(data.file_path, line.n, col, message::ErrorType::Syntax);
-                err->set_message("Syntax Error: '" + sub + "'");
+                err->set_message("Expected '+', '-' or ']', got '" + std::string(1, sign) + "'");
                 msgs.add(err);
                 return;
             }
 
-            argument.update(instruction::ArgumentType::LabelLiteral, 0);
-            argument.set_label(sub);
-        } else {
-            // Substitute label value
-            argument.update(instruction::ArgumentType::Literal, label->second.addr);
+            col++;
+            skip_whitespace(line.data, col);
+            int start = col;
+            int reg = parse_register(line.data, col);
+
+            if (reg != -1) {
+                // Index register, optionally scaled
+                if (scale != 0 || sign == '-') {
+                    auto err = new class message::Error(data.file_path, line.n, start, message::ErrorType::Syntax);
+                    err->set_message("Expected a single, added index register");
+                    msgs.add(err);
+                    return;
+                }
+
+                index = reg;
+                scale = 1;
+                skip_whitespace(line.data, col);
+
+                if (line.data[col] == '*') {
+                    col++;
+                    skip_whitespace(line.data, col);
+                    start = col;
+                    while (col < line.data.size() && std::isalnum(line.data[col]))
+                        col++;
+
+                    unsigned long long number;
+                    double _1;
+                    bool _2;
+
+                    if (!parse_number(line.data.substr(start, col - start), _2, number, _1) ||
+                        (number != 1 && number != 2 && number != 4 && number != 8)) {
+                        auto err = new class message::Error(data.file_path, line.n, start, message::ErrorType::Syntax);
+                        err->set_message("Scale must be one of 1, 2, 4 or 8");
+                        msgs.add(err);
+                        return;
+                    }
+
+                    scale = (int) number;
+                }
+            } else {
+                // Displacement
+                while (col < line.data.size() && std::isalnum(line.data[col]))
+                    col++;
+
+                unsigned long long number;
+                double _1;
+                bool _2;
+
+                if (start == col || !parse_number(line.data.substr(start, col - start), _2, number, _1)) {
+                    auto err = new class message::Error(data.file_path, line.n, start, message::ErrorType::Syntax);
+                    err->set_message("Expected register or number, got '" + line.data.substr(start, col - start) + "'");
+                    msgs.add(err);
+                    return;
+                }
+
+                disp += sign == '-' ? -(long long) number : (long long) number;
+            }
+        }
+
+        if (disp < INT32_MIN || disp > INT32_MAX) {
+            auto err = new class message::Error(data.file_path, line.n, col, message::ErrorType::Syntax);
+            err->set_message("Displacement " + std::to_string(disp) + " does not fit in 32 bits");
+            msgs.add(err);
+            return;
+        }
+
+        argument.update(instruction::ArgumentType::Indexed, instruction::Argument::pack_indexed(base, index, scale, (int) disp));
+    }
+
+    bool is_expression(const std::string &string, int col, bool allow_spaces) {
+        for (int i = col; i < string.size(); i++) {
+            char c = string[i];
+
+            if (c == ',' || c == ']' || (c == ' ' && !allow_spaces))
+                return false;
+
+            // Skip character and string literals, which may contain operators
+            if (c == '\'' || c == '"') {
+                for (i++; i < string.size() && string[i] != c; i++) {
+                    if (string[i] == '\\')
+                        i++;
+                }
+
+                continue;
+            }
+
+            // A leading '-' may be part of a number
+            if (c == '-' && i == col && i + 1 < string.size() && std::isdigit(string[i + 1]))
+                continue;
+
+            if (c == '(' || c == ')' || c == '$' || c == '~' || expression::get_precedence(c) != -1)
+                return true;
+        }
+
+        return false;
+    }
+
+    /** Parse binary operators binding at least as tightly as <precedence>. <depth> is the number of open parentheses. */
+    static void parse_expression_binary(Data &data, int line_idx, int &col, message::List &msgs,
+                                        expression::Expression &expression, int depth, int precedence);
+
+    /** Get the byte-size of the given data type, or 0. */
+    static int get_type_size(const std::string &type) {
+        if (type == "u8" || type == "i8")
+            return 1;
+
+        if (type == "u16" || type == "i16")
+            return 2;
+
+        if (type == "u32" || type == "i32" || type == "f32")
+            return 4;
+
+        if (type == "u64" || type == "i64" || type == "f64")
+            return 8;
+
+        return 0;
+    }
+
+    /** Parse a single operand of an expression, which may be preceded by unary operators. */
+    static void parse_expression_operand(Data &data, int line_idx, int &col, message::List &msgs,
+                                         expression::Expression &expression, int depth) {
+        auto &line = data.lines[line_idx];
+
+        if (depth > 0)
+            skip_whitespace(line.data, col);
+
+        int start = col;
+        char c = col < line.data.size() ? line.data[col] : '\0';
+
+        // Unary operator
+        if (c == '-' || c == '+' || c == '~') {
+            col++;
+            parse_expression_operand(data, line_idx, col, msgs, expression, depth);
+            expression.push_back({ expression::Token::Type::Unary, 0, nullptr, c });
+            return;
+        }
+
+        // Sub-expression
+        if (c == '(') {
+            col++;
+            parse_expression_binary(data, line_idx, col, msgs, expression, depth + 1, 0);
+
+            if (msgs.has_errors())
+                return;
+
+            skip_whitespace(line.data, col);
+
+            if (col >= line.data.size() || line.data[col] != ')') {
+                message::Message *msg = new class message::Error(data.file_path, line.n, col, message::ErrorType::Syntax);
+                msg->set_message("Expected ')'");
+                msgs.add(msg);
+
+                msg = new message::Message(message::Level::Note, data.file_path, line.n, start);
+                msg->set_message("Group opened here");
+                msgs.add(msg);
+
+                return;
+            }
+
+            col++;
+            return;
+        }
+
+        // Current address
+        if (c == '$') {
+            col++;
+            expression.push_back({ expression::Token::Type::Here, 0, nullptr, 0 });
+            return;
+        }
+
+        // Character literal
+        if (c == '\'') {
+            unsigned long long value;
+            parse_character_literal(data, line_idx, ++col, msgs, value);
+            expression.push_back({ expression::Token::Type::Number, value, nullptr, 0 });
+            return;
+        }
+
+        while (col < line.data.size() && (std::isalnum(line.data[col]) || line.data[col] == '_' || line.data[col] == '.'))
+            col++;
+
+        std::string word = line.data.substr(start, col - start);
+
+        if (word.empty()) {
+            auto err = new class message::Error(data.file_path, line.n, col, message::ErrorType::BadExpression);
+            err->set_message(c == '\0' ? "Expected operand, got end-of-line" : "Expected operand, got '" + std::string(1, c) + "'");
+            msgs.add(err);
+            return;
+        }
+
+        // sizeof(type) or sizeof(label)
+        if (word == "sizeof") {
+            skip_whitespace(line.data, col);
+
+            if (line.data[col] != '(') {
+                auto err = new class message::Error(data.file_path, line.n, col, message::ErrorType::BadExpression);
+                err->set_message("Expected '(' after sizeof");
+                msgs.add(err);
+                return;
+            }
+
+            skip_whitespace(line.data, ++col);
+            int name_start = col;
+
+            while (col < line.data.size() && (std::isalnum(line.data[col]) || line.data[col] == '_'))
+                col++;
+
+            std::string name = line.data.substr(name_start, col - name_start);
+            skip_whitespace(line.data, col);
+
+            if (line.data[col] != ')' || (get_type_size(name) == 0 && !is_valid_label_name(name))) {
+                auto err = new class message::Error(data.file_path, line.n, name_start, message::ErrorType::BadExpression);
+                err->set_message("Expected sizeof(type) or sizeof(label)");
+                msgs.add(err);
+                return;
+            }
+
+            col++;
+
+            if (int size = get_type_size(name))
+                expression.push_back({ expression::Token::Type::Number, (unsigned long long) size, nullptr, 0 });
+            else
+                expression.push_back({ expression::Token::Type::SizeOf, 0, data.intern_label(name), 0 });
+
+            return;
+        }
+
+        // Registers are only known at runtime
+        int j = 0;
+
+        if (parse_register(word, j) != -1 && j == word.size()) {
+            auto err = new class message::Error(data.file_path, line.n, start, message::ErrorType::BadExpression);
+            err->set_message("Register " + word + " cannot be used in an expression");
+            msgs.add(err);
+            return;
         }
+
+        // Number, which must span the whole word (besides its radix suffix)
+        int radix = get_radix(word.back());
+        j = 0;
+        bool is_decimal = scan_number(word, radix, j);
+
+        if (j > 0 && (j == word.size() || (radix != -1 && j == word.size() - 1))) {
+            unsigned long long v_int;
+            double v_dbl;
+            parse_number(word, is_decimal, v_int, v_dbl);
+
+            if (is_decimal) {
+                auto err = new class message::Error(data.file_path, line.n, start, message::ErrorType::BadExpression);
+                err->set_message("Floating-point number " + word + " cannot be used in an expression");
+                msgs.add(err);
+                return;
+            }
+
+            expression.push_back({ expression::Token::Type::Number, v_int, nullptr, 0 });
+            return;
+        }
+
+        if (!is_valid_label_name(word)) {
+            auto err = new class message::Error(data.file_path, line.n, start, message::ErrorType::BadExpression);
+            err->set_message("Expected number or label, got '" + word + "'");
+            msgs.add(err);
+            return;
+        }
+
+        expression.push_back({ expression::Token::Type::Label, 0, data.intern_label(word), 0 });
+    }
+
+    static void parse_expression_binary(Data &data, int line_idx, int &col, message::List &msgs,
+                                        expression::Expression &expression, int depth, int precedence) {
+        auto &line = data.lines[line_idx];
+        parse_expression_operand(data, line_idx, col, msgs, expression, depth);
+
+        while (!msgs.has_errors()) {
+            int j = col;
+
+            if (depth > 0)
+                skip_whitespace(line.data, j);
+
+            if (j >= line.data.size())
+                return;
+
+            // Shifts are written as two characters
+            char op = line.data[j];
+            int length = 1;
+
+            if (op == '<' || op == '>') {
+                if (j + 1 >= line.data.size() || line.data[j + 1] != op)
+                    return;
+
+                length = 2;
+            }
+
+            int op_precedence = expression::get_precedence(op);
+
+            if (op_precedence == -1 || op_precedence < precedence)
+                return;
+
+            col = j + length;
+            parse_expression_binary(data, line_idx, col, msgs, expression, depth, op_precedence + 1);
+            expression.push_back({ expression::Token::Type::Binary, 0, nullptr, op });
+        }
+    }
+
+    void parse_expression(Data &data, int line_idx, int &col, message::List &msgs, expression::Expression &expression,
+                          bool allow_spaces) {
+        parse_expression_binary(data, line_idx, col, msgs, expression, allow_spaces ? 1 : 0, 0);
+
+        if (allow_spaces)
+            skip_whitespace(data.lines[line_idx].data, col);
     }
 
     int parse_register(const std::string& s, int &i) {
@@ -630,7 +1097,8 @@ namespace assembler::parser {
         col++;
     }
 
-    void parse_byte_item(const Data &data, int line_idx, int &col, message::List &msgs, const AddBytesFunction& add_bytes) {
+    void parse_byte_item(Data &data, int line_idx, int &col, message::List &msgs, const AddBytesFunction& add_bytes,
+                         const AddExpressionFunction &add_expression) {
         auto& line = data.lines[line_idx];
 
         // Have we a character?
@@ -638,11 +1106,11 @@ namespace assembler::parser {
             unsigned long long value;
             parse_character_literal(data, line_idx, ++col, msgs, value);
 
-            if (msgs.has_message_of(message::Level::Error)) {
+            if (msgs.has_errors()) {
                 return;
             }
 
-            add_bytes(value, 0.0, false);
+            add_bytes(value, 0.0, false, false);
             return;
         }
 
@@ -661,10 +1129,10 @@ namespace assembler::parser {
                         msgs.add(err);
                         return;
                     } else {
-                        add_bytes(value, 0.0, false);
+                        add_bytes(value, 0.0, false, false);
                     }
                 } else {
-                    add_bytes(line.data[col++], 0.0, false);
+                    add_bytes(line.data[col++], 0.0, false, false);
                 }
             }
 
@@ -680,6 +1148,18 @@ namespace assembler::parser {
             return;
         }
 
+        // Have we an expression?
+        if (is_expression(line.data, col, false)) {
+            int start = col;
+            expression::Expression expression;
+            parse_expression(data, line_idx, col, msgs, expression);
+
+            if (!msgs.has_errors())
+                add_expression(start, std::move(expression));
+
+            return;
+        }
+
         // Extract characters
         int start = col;
         skip_to_break(line.data,col);
@@ -702,7 +1182,7 @@ namespace assembler::parser {
         bool is_dbl;
 
         if (parse_number(sub, is_dbl, number_int, number_dbl)) {
-            add_bytes(number_int, number_dbl, is_dbl);
+            add_bytes(number_int, number_dbl, is_dbl, false);
             return;
         }
 
@@ -723,12 +1203,13 @@ namespace assembler::parser {
 
             return;
         } else {
-            add_bytes(label->second.addr, 0.0, false);
+            add_bytes(label->second.addr, 0.0, false, true);
             return;
         }
     }
 
-    void parse_byte_sequence(const Data &data, int line_idx, int &col, message::List &msgs, const AddBytesFunction& add_bytes) {
+    void parse_byte_sequence(Data &data, int line_idx, int &col, message::List &msgs, const AddBytesFunction& add_bytes,
+                             const AddExpressionFunction &add_expression) {
         auto& line = data.lines[line_idx];
         int start = col;
 
@@ -739,10 +1220,10 @@ namespace assembler::parser {
                 break;
 
             // Parse item
-            parse_byte_item(data, line_idx, col, msgs, add_bytes);
+            parse_byte_item(data, line_idx, col, msgs, add_bytes, add_expression);
 
             // Any errors?
-            if (msgs.has_message_of(message::Level::Error)) {
+            if (msgs.has_errors()) {
                 auto msg = new message::Message(message::Level::Note, data.file_path, line.n, start);
                 msg->set_message("Data sequence starts here");
                 msgs.add(msg);
@@ -4,8 +4,11 @@
 #include "messages/list.hpp"
 #include <unordered_set>
 
-/** (v_int, v_dbl, is_dbl) */
-using AddBytesFunction = std::function<void(unsigned long long, double, bool)>;
+/** (v_int, v_dbl, is_dbl, is_label) */
+using AddBytesFunction = std::function<void(unsigned long long, double, bool, bool)>;
+
+/** (col, expression): add an item whose value is given by an expression. */
+using AddExpressionFunction = std::function<void(int, assembler::expression::Expression &&)>;
 
 namespace assembler::parser {
     /** List of valid section names. */
@@ -14,14 +17,23 @@ namespace assembler::parser {
     /** Parse lines into chunks. */
     void parse(Data &data, message::List &msgs);
 
-    /** Parse constant "<type>: <sequence>". Create byte vector on heap. Return if success. */
-    bool parse_data(const Data &data, int line_idx, int &col, message::List &msgs, std::vector<unsigned char> **bytes);
+    /** Parse constant "<type>: <sequence>", appending its bytes to <bytes>. Return if success.
+     * If <relocations> is given, label addresses are recorded in it (offsets being relative to the start of <bytes>).
+     * Items given by expressions are added to `data.expressions`, for the chunk which is to be created next. */
+    bool parse_data(Data &data, int line_idx, int &col, message::List &msgs, std::vector<unsigned char> &bytes,
+                    std::vector<Relocation> *relocations = nullptr);
+
+    /** Parse an argument, populate <argument>. If its value is given by an expression, this is placed in <expression>. */
+    void parse_arg(Data &data, int line_idx, int &col, message::List &msgs, instruction::Argument &argument,
+                   expression::Expression &expression);
 
-    /** Parse an argument, populate <argument>. */
-    void parse_arg(const Data &data, int line_idx, int &col, message::List &msgs, instruction::Argument &argument);
+    /** Given a string, return argument type and value - register, literal, label (lit), or an expression (placed in
+     * <expression>). User must check if end character is valid. Expressions may contain spaces. */
+    void parse_arg_lit(Data &data, int line_idx, int &col, message::List &msgs, instruction::Argument &argument,
+                       expression::Expression &expression);
 
-    /** Given a string, return argument type and value - register, literal, label (lit). User must check if end character is valid. */
-    void parse_arg_lit(const Data &data, int line_idx, int &col, message::List &msgs, instruction::Argument &argument);
+    /** Parse the remainder of an indexed operand "[base + index*scale + disp]", given <argument> holds the base register. Stops at ']'. */
+    void parse_arg_indexed(const Data &data, int line_idx, int &col, message::List &msgs, instruction::Argument &argument);
 
     /** Given a string, return register offset, or -1. */
     int parse_register(const std::string& string, int &index);
@@ -29,12 +41,23 @@ namespace assembler::parser {
     /** Parse numeric literal: int or float. Return if we did find a number. */
     bool parse_number(const std::string& string, bool& is_decimal, unsigned long long& v_int, double &v_dbl);
 
+    /** Is the operand at <col> an expression, rather than a single register, number or label? */
+    bool is_expression(const std::string &string, int col, bool allow_spaces);
+
+    /** Parse an expression in infix notation. Outside of parentheses, it ends at a space unless <allow_spaces>.
+     * Operands are numbers, characters, labels, `$` and `sizeof(type|label)`. Operators are, from loosest to tightest:
+     * `|`, `^`, `&`, `<< >>`, `+ -`, `* / %`, and unary `- + ~`. */
+    void parse_expression(Data &data, int line_idx, int &col, message::List &msgs, expression::Expression &expression,
+                          bool allow_spaces = false);
+
     /** Parse character. String assumed to have started with an apostrophe, with <index> pointing after this. */
     void parse_character_literal(const Data &data, int line_idx, int &col, message::List &msgs, unsigned long long& value);
 
     /** Given a string, add bytes to data that it represents. Parse only a single data item e.g. '42'. */
-    void parse_byte_item(const Data &data, int line_idx, int &col, message::List &msgs, const AddBytesFunction& add_bytes);
+    void parse_byte_item(Data &data, int line_idx, int &col, message::List &msgs, const AddBytesFunction& add_bytes,
+                         const AddExpressionFunction &add_expression);
 
     /** Given a string, add bytes to data that it represents. Parse an entire data string e.g., '42 0 '\0'' */
-    void parse_byte_sequence(const Data &data, int line_idx, int &col, message::List &msgs, const AddBytesFunction& add_bytes);
+    void parse_byte_sequence(Data &data, int line_idx, int &col, message::List &msgs, const AddBytesFunction& add_bytes,
+                             const AddExpressionFunction &add_expression);
 }
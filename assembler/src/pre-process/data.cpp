@@ -15,11 +15,7 @@ namespace assembler::pre_processor {
         return stream.str();
     }
 
-    void Data::merge(pre_processor::Data &other, int line_index) {
-        // Merge lines
-        auto lines_ptr = line_index < 0 ? (lines.end() - 1 + line_index) : (lines.begin() + line_index);
-        lines.insert(lines_ptr, other.lines.begin(), other.lines.end());
-
+    void Data::merge(pre_processor::Data &other) {
         // Merge constants
         constants.insert(other.constants.begin(), other.constants.end());
 
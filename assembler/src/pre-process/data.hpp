@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <unordered_map>
 
 #include "constant.hpp"
 #include "line.hpp"
@@ -13,9 +14,11 @@ namespace assembler::pre_processor {
         std::filesystem::path file_path;  // Name of source file
         bool debug;               // Print debug comments?
         std::vector<Line> lines;  // List of source file lines
-        std::map<std::string, Constant> constants; // Map of constant values (%define)
-        std::map<std::string, Macro> macros; // Map of macros
+        std::unordered_map<std::string, Constant> constants; // Map of constant values (%define)
+        std::unordered_map<std::string, Macro> macros; // Map of macros
         std::map<std::filesystem::path, LocationInformation> included_files; // Maps included files to where they were included
+        std::vector<std::filesystem::path> dependencies; // Canonical paths of every file %include-d, directly or not
+        std::filesystem::path include_cache; // Directory to cache pre-processed `lib:` includes in, or empty to disable
 
         explicit Data(bool debug) {
             this->debug = debug;
@@ -25,15 +28,19 @@ namespace assembler::pre_processor {
             debug = data.debug;
             file_path = data.file_path;
             executable = data.executable;
+            include_cache = data.include_cache;
         }
 
         /** Set executable path. */
         void set_executable(const std::string& path);
 
+        /** Get path of the library directory, used by `%include lib:...`. */
+        [[nodiscard]] std::filesystem::path get_lib_directory() const { return executable.parent_path().parent_path() / "lib"; }
+
         /** Writes `lines` to buffer. */
         std::string write_lines();
 
-        /** Merge given data with this. Insert lines starting at `index`. */
-        void merge(struct Data &other, int line_index = -1);
+        /** Merge constants and macros of given data into this. Lines are not merged. */
+        void merge(struct Data &other);
     };
 }
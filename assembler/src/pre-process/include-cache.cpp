@@ -0,0 +1,259 @@
+#include "include-cache.hpp"
+#include "../binary_io.hpp"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+namespace assembler::pre_processor::include_cache {
+    using namespace binary_io;
+
+    /** Magic bytes at the start of a cache file. */
+    static const char magic[4] = { 'C', 'V', 'P', 'P' };
+
+    struct Entry {
+        uint64_t hash; // Hash of the file's contents
+        std::vector<std::pair<std::filesystem::path, uint64_t>> dependencies; // Included files and their hashes
+        std::vector<std::pair<std::string, Constant>> constants;
+        std::vector<std::pair<std::string, Macro>> macros;
+        std::vector<Line> lines;
+    };
+
+    /** Entries loaded or stored during this run, by canonical path. */
+    static std::map<std::filesystem::path, Entry> memory;
+    static std::mutex memory_mutex; // Files may be assembled in parallel
+    static bool memory_only = false; // Cache in memory, even if there is no cache directory?
+
+    /** Get path of the cache file for the given canonical path. */
+    static std::filesystem::path get_cache_path(const Data &parent, const std::filesystem::path &file) {
+        std::string path = file.string();
+        std::stringstream name;
+        name << file.filename().string() << '.' << std::hex << hash_bytes(path.data(), path.size()) << ".ppc";
+
+        return parent.include_cache / name.str();
+    }
+
+    /** Is the entry up-to-date for <file>, and usable from <parent>? */
+    static bool is_valid(const Data &parent, const std::filesystem::path &file, const Entry &entry) {
+        uint64_t hash;
+
+        if (!hash_file(file, hash) || hash != entry.hash)
+            return false;
+
+        for (const auto &dependency : entry.dependencies) {
+            // Including this would be circular, so go the long way to report it
+            if (parent.included_files.find(dependency.first) != parent.included_files.end())
+                return false;
+
+            if (!hash_file(dependency.first, hash) || hash != dependency.second)
+                return false;
+        }
+
+        return true;
+    }
+
+    static void write_entry(std::ostream &out, const Entry &entry) {
+        write_header(out, magic, version);
+        write_int(out, entry.hash);
+
+        write_int<uint32_t>(out, entry.dependencies.size());
+
+        for (const auto &dependency : entry.dependencies) {
+            write_string(out, dependency.first.string());
+            write_int(out, dependency.second);
+        }
+
+        write_int<uint32_t>(out, entry.constants.size());
+
+        for (const auto &[name, constant] : entry.constants) {
+            write_string(out, name);
+            write_int<int32_t>(out, constant.line);
+            write_int<int32_t>(out, constant.col);
+            write_string(out, constant.value);
+        }
+
+        write_int<uint32_t>(out, entry.macros.size());
+
+        for (const auto &[name, macro] : entry.macros) {
+            write_string(out, name);
+            write_int<int32_t>(out, macro.line);
+            write_int<int32_t>(out, macro.col);
+
+            write_int<uint32_t>(out, macro.params.size());
+            for (const auto &param : macro.params)
+                write_string(out, param);
+
+            write_int<uint32_t>(out, macro.lines.size());
+            for (const auto &line : macro.lines)
+                write_string(out, line);
+        }
+
+        write_int<uint32_t>(out, entry.lines.size());
+
+        for (const auto &line : entry.lines) {
+            write_int<int32_t>(out, line.n);
+            write_string(out, line.data);
+        }
+    }
+
+    static bool read_entry(std::istream &in, Entry &entry) {
+        uint32_t count, sub_count;
+
+        if (!read_header(in, magic, version) || !read_int(in, entry.hash))
+            return false;
+
+        if (!read_int(in, count))
+            return false;
+
+        for (uint32_t i = 0; i < count; i++) {
+            std::string path;
+            uint64_t hash;
+
+            if (!read_string(in, path) || !read_int(in, hash))
+                return false;
+
+            entry.dependencies.emplace_back(path, hash);
+        }
+
+        if (!read_int(in, count))
+            return false;
+
+        for (uint32_t i = 0; i < count; i++) {
+            std::string name;
+            Constant constant;
+            int32_t line, col;
+
+            if (!read_string(in, name) || !read_int(in, line) || !read_int(in, col) || !read_string(in, constant.value))
+                return false;
+
+            constant.line = line;
+            constant.col = col;
+            entry.constants.emplace_back(std::move(name), std::move(constant));
+        }
+
+        if (!read_int(in, count))
+            return false;
+
+        for (uint32_t i = 0; i < count; i++) {
+            std::string name;
+            int32_t line, col;
+            std::vector<std::string> params, lines;
+
+            if (!read_string(in, name) || !read_int(in, line) || !read_int(in, col) || !read_int(in, sub_count))
+                return false;
+
+            params.resize(sub_count);
+            for (auto &param : params)
+                if (!read_string(in, param))
+                    return false;
+
+            if (!read_int(in, sub_count))
+                return false;
+
+            lines.resize(sub_count);
+            for (auto &macro_line : lines)
+                if (!read_string(in, macro_line))
+                    return false;
+
+            Macro macro(line, col, std::move(params));
+            macro.lines = std::move(lines);
+            entry.macros.emplace_back(std::move(name), std::move(macro));
+        }
+
+        if (!read_int(in, count))
+            return false;
+
+        entry.lines.resize(count);
+
+        for (auto &line : entry.lines) {
+            int32_t n;
+
+            if (!read_int(in, n) || !read_string(in, line.data))
+                return false;
+
+            line.n = n;
+        }
+
+        return true;
+    }
+
+    void keep_in_memory() {
+        memory_only = true;
+    }
+
+    bool load(const Data &parent, const std::filesystem::path &file, Data &data) {
+        if (parent.include_cache.empty() && !memory_only)
+            return false;
+
+        std::lock_guard<std::mutex> lock(memory_mutex);
+        auto cached = memory.find(file);
+
+        // Not seen this run, so try the disk
+        if (cached == memory.end()) {
+            if (parent.include_cache.empty())
+                return false;
+
+            std::ifstream in(get_cache_path(parent, file), std::ios::binary);
+            Entry entry;
+
+            if (!in.good() || !read_entry(in, entry))
+                return false;
+
+            cached = memory.insert({ file, std::move(entry) }).first;
+        }
+
+        const Entry &entry = cached->second;
+
+        if (!is_valid(parent, file, entry)) {
+            memory.erase(cached);
+            return false;
+        }
+
+        data.constants.clear();
+        data.constants.insert(entry.constants.begin(), entry.constants.end());
+        data.macros.clear();
+        data.macros.insert(entry.macros.begin(), entry.macros.end());
+        data.lines = entry.lines;
+        data.dependencies.clear();
+
+        for (const auto &dependency : entry.dependencies)
+            data.dependencies.push_back(dependency.first);
+
+        return true;
+    }
+
+    void store(const Data &parent, const std::filesystem::path &file, const Data &data) {
+        if (parent.include_cache.empty() && !memory_only)
+            return;
+
+        Entry entry;
+
+        if (!hash_file(file, entry.hash))
+            return;
+
+        for (const auto &dependency : data.dependencies) {
+            uint64_t hash;
+
+            if (!hash_file(dependency, hash))
+                return;
+
+            entry.dependencies.emplace_back(dependency, hash);
+        }
+
+        entry.constants.assign(data.constants.begin(), data.constants.end());
+        entry.macros.assign(data.macros.begin(), data.macros.end());
+        entry.lines = data.lines;
+
+        if (!parent.include_cache.empty()) {
+            std::error_code error;
+            std::filesystem::create_directories(parent.include_cache, error);
+
+            write_atomically(get_cache_path(parent, file), [&entry](std::ostream &out) {
+                write_entry(out, entry);
+            });
+        }
+
+        std::lock_guard<std::mutex> lock(memory_mutex);
+        memory.insert_or_assign(file, std::move(entry));
+    }
+}
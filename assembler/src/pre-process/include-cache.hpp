@@ -0,0 +1,23 @@
+#pragma once
+
+#include <filesystem>
+
+#include "data.hpp"
+
+/** Cache of pre-processed library (`lib:`) includes, kept in memory and on disk in the directory `Data::include_cache`.
+ * An entry holds the constants, macros and lines resulting from pre-processing a file, and is keyed by the content hash
+ * of that file and of every file it (transitively) includes. */
+namespace assembler::pre_processor::include_cache {
+    /** Bump whenever the on-disk format, or the output of the pre-processor, changes. */
+    constexpr uint32_t version = 1;
+
+    /** Keep entries in memory for the rest of this run, even without a cache directory. For long-running processes. */
+    void keep_in_memory();
+
+    /** Attempt to fill <data> with the cached result of pre-processing <file>, which is being included from <parent>.
+     * Return whether there was a valid cache entry. */
+    bool load(const Data &parent, const std::filesystem::path &file, Data &data);
+
+    /** Cache the result of pre-processing <file>, held in <data>. Failure to write to disk is silently ignored. */
+    void store(const Data &parent, const std::filesystem::path &file, const Data &data);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace assembler::pre_processor {
@@ -8,12 +9,16 @@ namespace assembler::pre_processor {
         int line;
         int col;
         std::vector<std::string> params;
+        std::unordered_map<std::string, int> param_index; // Maps parameter name to its index in `params`
         std::vector<std::string> lines; // Lines in macro's body
 
         Macro(int line, int col, std::vector<std::string> params) {
             this->line = line;
             this->col = col;
             this->params = std::move(params);
+
+            for (int i = 0; i < this->params.size(); i++)
+                param_index.insert({ this->params[i], i });
         }
     };
 }
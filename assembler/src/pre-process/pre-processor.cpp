@@ -2,13 +2,95 @@
 #include "util.hpp"
 #include "messages/error.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <string_view>
 #include "data.hpp"
+#include "include-cache.hpp"
 
 namespace assembler {
+    /** Is `c` part of an identifier token? */
+    static inline bool is_symbol_char(char c) {
+        return std::isalnum((unsigned char) c) || c == '_';
+    }
+
+    /** Replace each identifier token in `text` for which `lookup(symbol, out)` appends a replacement to `out` and
+     * returns true. String and character literals are copied verbatim. Return whether anything was replaced. */
+    template<typename Lookup>
+    static bool substitute_symbols(std::string &text, Lookup lookup) {
+        std::string out;
+        bool changed = false;
+        size_t copied = 0; // Everything before this index has been dealt with
+
+        for (size_t i = 0; i < text.size();) {
+            char c = text[i];
+
+            if (c == '"' || c == '\'') {
+                // Skip literal, honouring escapes
+                size_t j = i + 1;
+
+                while (j < text.size() && text[j] != c)
+                    j += text[j] == '\\' ? 2 : 1;
+
+                i = std::min(j + 1, text.size());
+            } else if (is_symbol_char(c)) {
+                size_t j = i;
+
+                while (j < text.size() && is_symbol_char(text[j]))
+                    j++;
+
+                size_t out_size = out.size();
+                out.append(text, copied, i - copied);
+
+                if (lookup(text.substr(i, j - i), out)) {
+                    changed = true;
+                    copied = j;
+                } else {
+                    out.resize(out_size);
+                }
+
+                i = j;
+            } else {
+                i++;
+            }
+        }
+
+        if (changed) {
+            out.append(text, copied, std::string::npos);
+            text = std::move(out);
+        }
+
+        return changed;
+    }
+
+    /** Substitute constants in `text`. A constant's value is expanded in turn, except for constants in `active`, which
+     * are currently being expanded. */
+    static void substitute_constants(std::string &text, const pre_processor::Data &data, int line_n,
+                                     std::vector<const std::string *> &active) {
+        substitute_symbols(text, [&](const std::string &symbol, std::string &out) {
+            auto constant = data.constants.find(symbol);
+
+            if (constant == data.constants.end() ||
+                std::find(active.begin(), active.end(), &constant->first) != active.end())
+                return false;
+
+            if (data.debug) {
+                std::cout << "[" << line_n << "] CONSTANT: substitute symbol " << symbol << "\n";
+            }
+
+            std::string value = constant->second.value;
+            active.push_back(&constant->first);
+            substitute_constants(value, data, line_n, active);
+            active.pop_back();
+
+            out += value;
+            return true;
+        });
+    }
+
     void read_source_file(const std::string& filename, pre_processor::Data &data, message::List &msgs) {
-        std::ifstream file(filename);
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
 
         // Check if the file exists
         if (!file.good()) {
@@ -23,28 +105,63 @@ namespace assembler {
             return;
         }
 
+        // Read the whole file in one go
+        auto size = file.tellg();
+        std::string buffer(size > 0 ? (size_t) size : 0, '\0');
+        file.seekg(0);
+        file.read(buffer.data(), (std::streamsize) buffer.size());
+        file.close();
+
+        read_source(filename, buffer, data);
+    }
+
+    void read_source(const std::string& filename, std::string_view source, pre_processor::Data &data) {
         // Initialise pre-processor data structure
         data.file_path = filename;
 
-        std::string str;
+        // Split into lines, only allocating for non-empty ones
+        data.lines.reserve(data.lines.size() + std::count(source.begin(), source.end(), '\n') + 1);
 
         int i = 0;
-        while (std::getline(file, str)) {
+        while (!source.empty()) {
+            size_t end = source.find('\n');
+            std::string_view str = source.substr(0, end);
+
             if (!str.empty())
-                data.lines.push_back({ i, str });
+                data.lines.push_back({ i, std::string(str) });
 
+            source.remove_prefix(end == std::string_view::npos ? source.size() : end + 1);
             i++;
         }
-
-        file.close();
     }
 
     void pre_process(pre_processor::Data &data, message::List &msgs) {
         // Keep track of the current macro (if nullptr we are not in a macro definition)
-        std::pair<std::string, pre_processor::Macro> *current_macro = nullptr;
-
-        for (int lines_idx = 0; lines_idx < data.lines.size(); lines_idx++) {
-            auto &line = data.lines[lines_idx];
+        std::pair<const std::string, pre_processor::Macro> *current_macro = nullptr;
+
+        // Source lines are consumed in order and surviving lines are appended to data.lines. Lines produced by a
+        // macro expansion or an %include are pushed onto `pending` in reverse, so they are processed next.
+        std::vector<Line> source = std::move(data.lines);
+        std::vector<Line> pending;
+        size_t source_idx = 0;
+
+        // Constants currently being expanded, to stop self-referential definitions recursing
+        std::vector<const std::string *> active_constants;
+
+        data.lines.clear();
+        data.lines.reserve(source.size());
+
+        while (true) {
+            Line line;
+
+            if (!pending.empty()) {
+                line = std::move(pending.back());
+                pending.pop_back();
+            } else if (source_idx < source.size()) {
+                line = std::move(source[source_idx++]);
+            } else {
+                break;
+            }
 
             // Trim leading and trailing whitespace
             trim(line.data);
@@ -63,18 +180,15 @@ namespace assembler {
             }
 
             // Remove any whitespace which may be left over after comment was removed
-            if (was_comment) {
+            if (was_comment)
                 rtrim(line.data);
 
-                if (line.data.empty()) {
-                    data.lines.erase(data.lines.begin() + lines_idx);
-                    lines_idx--;
-                    continue;
-                }
-            }
+            if (line.data.empty())
+                continue;
 
             // Section header?
             if (starts_with(line.data, ".section")) {
+                data.lines.push_back(std::move(line));
                 continue;
             }
 
@@ -117,6 +231,14 @@ namespace assembler {
                         skip_non_whitespace(line.data, i);
                         std::string constant = line.data.substr(j, i - j);
 
+                        // Check if name is valid
+                        if (!is_valid_label_name(constant)) {
+                            auto error = new class message::Error(data.file_path, line.n, j, message::ErrorType::InvalidLabel);
+                            error->set_message("Invalid constant name \"" + constant + "\"");
+                            msgs.add(error);
+                            return;
+                        }
+
                         if (data.debug) {
                             std::cout << "\tConstant: " << constant;
                         }
@@ -164,8 +286,10 @@ namespace assembler {
                         std::filesystem::path full_path = data.file_path.parent_path();
 
                         // Library path?
-                        if (starts_with(file_path, "lib:")) {
-                            full_path = data.executable.parent_path().parent_path() / "lib" / std::filesystem::path(file_path.substr(4) + ".asm");
+                        bool is_lib = starts_with(file_path, "lib:");
+
+                        if (is_lib) {
+                            full_path = data.get_lib_directory() / std::filesystem::path(file_path.substr(4) + ".asm");
                         } else {
                             full_path = data.file_path.parent_path() / std::filesystem::path(file_path);
                         }
@@ -182,14 +306,14 @@ namespace assembler {
                         // Read included file
                         read_source_file(full_path.string(), include_data, include_messages);
 
-                        if (include_messages.has_message_of(message::Level::Error)) {
+                        if (include_messages.has_errors()) {
                             // Try appending ".asm"
                             full_path += ".asm";
                             include_messages.clear();
                             read_source_file(full_path.string(), include_data, include_messages);
                         }
 
-                        if (include_messages.has_message_of(message::Level::Error)) {
+                        if (include_messages.has_errors()) {
                             msgs.append(include_messages);
 
                             auto *msg = new message::Message(message::Level::Note, data.file_path, line.n, i);
@@ -222,16 +346,29 @@ namespace assembler {
                         include_data.included_files.insert(data.included_files.begin(), data.included_files.end());
                         include_data.included_files.insert({ canonical_path, { data.file_path, line.n, i } });
 
-                        // Pre-process included file
-                        pre_process(include_data, include_messages);
+                        // Pre-process included file, unless a library whose result is cached
+                        if (is_lib && pre_processor::include_cache::load(data, canonical_path, include_data)) {
+                            if (data.debug) {
+                                std::cout << "\tLoaded from include cache\n";
+                            }
+                        } else {
+                            pre_process(include_data, include_messages);
+
+                            if (include_messages.has_errors()) {
+                                msgs.append(include_messages);
+                                return;
+                            }
 
-                        if (include_messages.has_message_of(message::Level::Error)) {
-                            msgs.append(include_messages);
-                            return;
+                            if (is_lib)
+                                pre_processor::include_cache::store(data, canonical_path, include_data);
                         }
 
-                        // Merge data
-                        data.merge(include_data, lines_idx + 1);
+                        // Merge symbols, and process the included lines next
+                        data.dependencies.push_back(canonical_path);
+                        data.dependencies.insert(data.dependencies.end(), include_data.dependencies.begin(), include_data.dependencies.end());
+                        data.merge(include_data);
+                        pending.insert(pending.end(), std::make_move_iterator(include_data.lines.rbegin()),
+                                       std::make_move_iterator(include_data.lines.rend()));
                     } else if (directive == "macro") {
                         // %macro [NAME] <args...>
                         skip_alpha(line.data, i);
@@ -264,10 +401,6 @@ namespace assembler {
                             msg->set_message("Re-definition of macro " + macro_name + " (previously defined at "
                                     + std::to_string(macro_exists->second.line) + ':' + std::to_string(macro_exists->second.col) + ')');
                             msgs.add(msg);
-
-                            // Update value.
-                            macro_exists->second.line = line.n;
-                            macro_exists->second.col = j;
                         }
 
                         // Collect parameters
@@ -329,30 +462,25 @@ namespace assembler {
 
                         // Insert/update macro
                         if (macro_exists == data.macros.end()) {
-                            data.macros.insert({ macro_name, pre_processor::Macro(line.n, macro_name_index, macro_params) });
-                            macro_exists = data.macros.find(macro_name);
+                            macro_exists = data.macros.insert({ macro_name, pre_processor::Macro(line.n, macro_name_index, macro_params) }).first;
                         } else {
-                            macro_exists->second.params = macro_params;
+                            macro_exists->second = pre_processor::Macro(line.n, macro_name_index, macro_params);
                         }
 
                         // Set current_macro
-                        current_macro = reinterpret_cast<std::pair<std::string, pre_processor::Macro> *>(&*macro_exists);
+                        current_macro = &*macro_exists;
                     } else if (directive == "rm") {
                         // %rm: act as a comment
                         if (data.debug) {
                             std::cout << "\tIgnoring this line.\n";
                         }
                     } else if (directive == "stop") {
-                        // %stop: halt the pre-processor, remove all lines after this one
+                        // %stop: halt the pre-processor, discard all lines after this one
                         if (data.debug) {
-                            std::cout << "\tRemoving all lines past line " << lines_idx << "\n";
+                            std::cout << "\tDiscarding all lines past line " << line.n << "\n";
                         }
 
-                        while (data.lines.size() != lines_idx) {
-                            data.lines.pop_back();
-                        }
-
-                        break;
+                        return;
                     } else {
                         auto error = new class message::Error(data.file_path, line.n, 0, message::ErrorType::UnknownDirective);
                         error->set_message("Unknown directive %" + directive);
@@ -361,35 +489,17 @@ namespace assembler {
                     }
                 }
 
-                // Directive has been handles - now remove current line
-                data.lines.erase(data.lines.begin() + lines_idx);
-                lines_idx--;
-
+                // Directive has been handled - drop current line
                 continue;
             }
 
             // Replace constants in line with their value
-            for (const auto& pair : data.constants) {
-                size_t index = 0;
-
-                while ((index = line.data.find(pair.first, index)) != std::string::npos) {
-                    if (data.debug) {
-                        std::cout << "[" << line.n << ":" << index << "] CONSTANT: substitute symbol " << pair.first << "\n";
-                    }
-
-                    line.data.replace(index, pair.first.size(), pair.second.value);
-                    index += pair.second.value.size();
-                }
-            }
+            if (!data.constants.empty())
+                substitute_constants(line.data, data, line.n, active_constants);
 
             // If in macro, add to body
             if (current_macro) {
-                current_macro->second.lines.push_back(line.data);
-
-                // Remove line from normal program
-                data.lines.erase(data.lines.begin() + lines_idx);
-                lines_idx--;
-
+                current_macro->second.lines.push_back(std::move(line.data));
                 continue;
             }
 
@@ -459,40 +569,38 @@ namespace assembler {
                     return;
                 }
 
-                // Remove this line from the program - it will be replaced soon
-                data.lines.erase(data.lines.begin() + lines_idx);
+                // Queue macro's lines in place of this line (pushed in reverse, so the first line is processed next)
+                const auto &body = macro_exists->second.lines;
 
-                int insert_idx = lines_idx;
+                const auto &param_index = macro_exists->second.param_index;
 
-                // Insert macro's lines
-                for (auto macro_line : macro_exists->second.lines) {
-                    int arg_index = 0;
+                for (auto it = body.rbegin(); it != body.rend(); ++it) {
+                    std::string macro_line = *it;
 
                     // Replace any parameters with its respective argument value
-                    for (const auto& param : macro_exists->second.params) {
-                        size_t index = 0;
-                        std::string &arg = arguments[arg_index];
+                    if (!param_index.empty()) {
+                        substitute_symbols(macro_line, [&](const std::string &symbol, std::string &out) {
+                            auto param = param_index.find(symbol);
+
+                            if (param == param_index.end())
+                                return false;
 
-                        while ((index = macro_line.find(param, index)) != std::string::npos) {
                             if (data.debug) {
-                                std::cout << "\tCol " << index << ": EXPANSION: substitute parameter " << param << " with value \"" << arg << "\"\n";
+                                std::cout << "\tEXPANSION: substitute parameter " << symbol << " with value \"" << arguments[param->second] << "\"\n";
                             }
 
-                            macro_line.replace(index, param.size(), arg);
-                            index += arg.size();
-                        }
-
-                        arg_index++;
+                            out += arguments[param->second];
+                            return true;
+                        });
                     }
 
-                    // Add modified macro line to program body
-                    data.lines.insert(data.lines.begin() + insert_idx++, {line.n, macro_line});
+                    pending.push_back({ line.n, std::move(macro_line) });
                 }
 
-                // We have inserted the macro's body now, so we continue
-                lines_idx--;
                 continue;
             }
+
+            data.lines.push_back(std::move(line));
         }
     }
 }
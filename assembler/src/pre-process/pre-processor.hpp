@@ -8,6 +8,9 @@ namespace assembler {
     /** Read source file into lines. Mutate `data`, or add error. */
     void read_source_file(const std::string& filename, pre_processor::Data &data, message::List &msgs);
 
+    /** Split source text, as read from the given file, into lines. */
+    void read_source(const std::string& filename, std::string_view source, pre_processor::Data &data);
+
     /** Run pre-processing on the given data, mutating it, or add error. */
     void pre_process(pre_processor::Data &data, message::List &msgs);
 }
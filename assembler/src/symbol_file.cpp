@@ -0,0 +1,107 @@
+#include "symbol_file.hpp"
+#include "binary_io.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+namespace assembler::symbols {
+    using namespace binary_io;
+
+    /** Magic bytes at the start of a symbol file. */
+    static const char magic[4] = { 'C', 'V', 'M', 'S' };
+
+    int64_t Table::find_line(uint64_t address) const {
+        auto entry = std::upper_bound(lines.begin(), lines.end(), address, [](uint64_t address, const LineEntry &entry) {
+            return address < entry.address;
+        });
+
+        return entry == lines.begin() ? -1 : std::prev(entry)->line;
+    }
+
+    void Table::set_binary(const char *binary, size_t size) {
+        binary_size = size;
+        binary_hash = hash_bytes(binary, size);
+    }
+
+    bool Table::describes(const char *binary, size_t size) const {
+        return binary_size == size && binary_hash == hash_bytes(binary, size);
+    }
+
+    std::filesystem::path get_path(const std::filesystem::path &binary) {
+        auto path = binary;
+        path += ".sym";
+        return path;
+    }
+
+    void write(const Table &table, std::ostream &out) {
+        write_header(out, magic, version);
+        write_int(out, table.binary_size);
+        write_int(out, table.binary_hash);
+
+        write_int<uint32_t>(out, table.symbols.size());
+
+        for (const auto &symbol : table.symbols) {
+            write_string(out, symbol.name);
+            write_int(out, symbol.address);
+        }
+
+        // Each entry is stored as the distance from the last: addresses only increase, and lines are zig-zag encoded
+        write_int<uint32_t>(out, table.lines.size());
+        uint64_t address = 0;
+        int64_t line = 0;
+
+        for (const auto &entry : table.lines) {
+            auto delta = (uint64_t) (entry.line - line);
+            write_varint(out, entry.address - address);
+            write_varint(out, (delta << 1) ^ (uint64_t) ((int64_t) delta >> 63));
+            address = entry.address;
+            line = entry.line;
+        }
+    }
+
+    bool write(const Table &table, const std::filesystem::path &path) {
+        std::ofstream out(path, std::ios::binary);
+
+        if (!out.good())
+            return false;
+
+        write(table, out);
+        return out.good();
+    }
+
+    bool read(const std::filesystem::path &path, Table &table) {
+        std::ifstream in(path, std::ios::binary);
+        uint32_t count;
+
+        if (!read_header(in, magic, version) || !read_int(in, table.binary_size) || !read_int(in, table.binary_hash) ||
+            !read_int(in, count))
+            return false;
+
+        table.symbols.resize(count);
+
+        for (auto &symbol : table.symbols) {
+            if (!read_string(in, symbol.name) || !read_int(in, symbol.address))
+                return false;
+        }
+
+        if (!read_int(in, count))
+            return false;
+
+        table.lines.resize(count);
+        uint64_t address = 0;
+        int64_t line = 0;
+
+        for (auto &entry : table.lines) {
+            uint64_t address_delta, line_delta;
+
+            if (!read_varint(in, address_delta) || !read_varint(in, line_delta))
+                return false;
+
+            address += address_delta;
+            line += (int64_t) (line_delta >> 1) ^ -(int64_t) (line_delta & 1);
+            entry = { address, line };
+        }
+
+        return true;
+    }
+}
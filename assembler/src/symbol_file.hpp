@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** Debug symbols, written by `assembler -g` beside a binary as `<binary>.sym`. The binary itself is unchanged, so neither
+ * the processor nor stripped binaries pay for them.
+ * Holds every label, sorted by address, and a table mapping addresses to the source line they were assembled from. */
+namespace assembler::symbols {
+    /** Bump whenever the on-disk format changes. */
+    constexpr uint32_t version = 2;
+
+    struct Symbol {
+        std::string name;
+        uint64_t address;
+    };
+
+    /** Bytes from <address> up to the next entry were assembled from source line <line>, counting from 1. */
+    struct LineEntry {
+        uint64_t address;
+        int64_t line;
+    };
+
+    struct Table {
+        uint64_t binary_size = 0; // Size of the binary these symbols describe, including its header
+        uint64_t binary_hash = 0; // binary_io::hash_bytes of that binary
+        std::vector<Symbol> symbols; // Sorted by address, then name
+        std::vector<LineEntry> lines; // Sorted by address
+
+        /** Get the source line of the given address, or -1 if unknown. */
+        [[nodiscard]] int64_t find_line(uint64_t address) const;
+
+        /** Set the binary these symbols describe. */
+        void set_binary(const char *binary, size_t size);
+
+        /** Check whether these symbols describe the given binary, rather than one since overwritten. */
+        [[nodiscard]] bool describes(const char *binary, size_t size) const;
+    };
+
+    /** Get the path of the symbol file for the given binary. */
+    std::filesystem::path get_path(const std::filesystem::path &binary);
+
+    /** Write table to the given stream. */
+    void write(const Table &table, std::ostream &out);
+
+    /** Write table to the given file. Return whether this was successful. */
+    bool write(const Table &table, const std::filesystem::path &path);
+
+    /** Read table from the given file. Return whether this was successful. */
+    bool read(const std::filesystem::path &path, Table &table);
+}
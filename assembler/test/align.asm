@@ -0,0 +1,33 @@
+; Data alignment, and sharing of read-only data with -O
+main:
+    mov value, r1
+    and r1, 7
+    mov 0, r0
+    syscall ; Prints 0: value is aligned to 8 bytes
+    mov buffer, r1
+    and r1, 63
+    syscall ; Prints 0
+    mov [before], r1
+    syscall ; Prints 5678: a label before .align is moved with the chunk
+    mov 6, r0
+    mov 0, r2
+    mov hello, r1
+    syscall ; Prints "Hello, world"
+    mov world, r1
+    syscall ; Prints "world"
+    hlt
+
+.section data
+flag: u8 1
+.align 8
+value: u64 1234
+.align 64
+buffer: u8 0
+before:
+.align 8
+u64 5678
+
+.section rodata
+hello: u8 "Hello, world", 10, 0
+greeting: u8 "Hello, world", 10, 0 ; With -O, shares the bytes of hello
+world: u8 "world", 10, 0 ; With -O, shares the end of hello
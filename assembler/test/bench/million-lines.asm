@@ -0,0 +1,88 @@
+; Benchmark: expands to 1,000,000 instructions through nested macros.
+; Time with e.g. `time assembler million-lines.asm -o out.bin`.
+
+%macro x1
+    add r1, 1
+%end
+
+%macro x10
+    x1
+    x1
+    x1
+    x1
+    x1
+    x1
+    x1
+    x1
+    x1
+    x1
+%end
+
+%macro x100
+    x10
+    x10
+    x10
+    x10
+    x10
+    x10
+    x10
+    x10
+    x10
+    x10
+%end
+
+%macro x1000
+    x100
+    x100
+    x100
+    x100
+    x100
+    x100
+    x100
+    x100
+    x100
+    x100
+%end
+
+%macro x10000
+    x1000
+    x1000
+    x1000
+    x1000
+    x1000
+    x1000
+    x1000
+    x1000
+    x1000
+    x1000
+%end
+
+%macro x100000
+    x10000
+    x10000
+    x10000
+    x10000
+    x10000
+    x10000
+    x10000
+    x10000
+    x10000
+    x10000
+%end
+
+%macro x1000000
+    x100000
+    x100000
+    x100000
+    x100000
+    x100000
+    x100000
+    x100000
+    x100000
+    x100000
+    x100000
+%end
+
+main:
+    x1000000
+    hlt
\ No newline at end of file
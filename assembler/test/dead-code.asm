@@ -0,0 +1,27 @@
+; Assemble with -O: code and data which cannot be reached from main are removed
+main:
+    cal square
+    mov [table + 8], r1
+    syscall ; Prints 20
+    mov handlers, r2
+    mov [r2], r3
+    cal r3 ; Kept: its address is in handlers
+    hlt
+unused: ; Removed: never called
+    mov 99, r1
+    ret
+square:
+    mov 7, r1
+    mul r1, r1
+    mov 0, r0
+    syscall ; Prints 49
+    ret
+print_one:
+    mov 1, r1
+    syscall ; Prints 1
+    ret
+
+unused_data: u64 1, 2, 3 ; Removed: never referred to
+table: u64 10
+    u64 20 ; Kept: follows table
+handlers: u64 print_one
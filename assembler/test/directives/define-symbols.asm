@@ -0,0 +1,17 @@
+%include lib:macros
+%define N 4
+%define COUNT N
+%macro prn reg
+    print_int reg
+    print_newline
+%end
+
+; Only whole symbols are substituted: `N` is left alone in `NEXT` and in "N"
+mov COUNT, r5
+prn r5
+jmp NEXT
+NEXT:
+mov 'N', r2
+print_char r2
+print_newline
+hlt
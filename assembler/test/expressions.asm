@@ -0,0 +1,32 @@
+; Constant expressions, evaluated once labels have been laid out
+%define COUNT 3
+main:
+    mov 0, r0
+    mov (COUNT * 4 + 1), r1 ; 13
+    syscall
+    mov end - start, r1 ; 24
+    syscall
+    mov sizeof(msg), r1 ; 6
+    syscall
+    mov [table + 8], r1 ; 22
+    syscall
+    mov (1 << 4 | 3) ^ 1, r1 ; 18
+    syscall
+    mov 'a' + sizeof(u32), r1 ; 101
+    syscall
+    mov [count], r1 ; 3
+    syscall
+    jmp $ + 12 ; Skip the hlt: jmp is 10 bytes and hlt 2
+    hlt
+    mov 0, r1 ; Prints 0
+    syscall
+    hlt
+start:
+    u64 1, 2, 3
+end:
+msg:
+    u8 "Hello", 0
+table:
+    u64 11, 22, 33
+count:
+    u64 ((end - start) / 8)
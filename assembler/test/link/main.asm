@@ -0,0 +1,16 @@
+; Assemble with `assembler -c main.asm show.asm`, then `linker main.o show.o -o main.bin`
+main:
+mov 0, r1
+loop:
+cmp r1, 5
+jgt end
+jmp show
+cont:
+add r1, 1
+jmp loop
+end:
+mov 6, r0
+mov message, r1
+mov 0, r2
+syscall
+hlt
@@ -0,0 +1,12 @@
+; Labels used by main.asm
+show:
+mov 0, r0
+syscall
+mov [step], r5
+mov r1, r6
+mov r5, r1
+syscall
+mov r6, r1
+jmp cont
+step: u64 7
+message: u8 "Hi" 0
@@ -6,4 +6,5 @@ addf64 r1, r2
 addf64 r1, r2
 add 128, [200], [328]
 add 128, [200], 1
+add r1, [r2 + r3*8]
 hlt
\ No newline at end of file
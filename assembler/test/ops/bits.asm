@@ -0,0 +1,5 @@
+popc r1
+clz r1
+ctz r1
+bswp r1
+hlt
\ No newline at end of file
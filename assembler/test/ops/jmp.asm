@@ -8,4 +8,17 @@ jlt 100h
 jlt r3
 jgt 100h
 jgt r3
+djnz r1, 100h
+jeq r1, 10, 100h
+jeq r1, r2, 100h
+jne r1, 10, 100h
+jne r1, r2, 100h
+jlt r1, 10, 100h
+jlt r1, r2, 100h
+jle r1, 10, 100h
+jle r1, r2, 100h
+jgt r1, 10, 100h
+jgt r1, r2, 100h
+jge r1, 10, 100h
+jge r1, r2, 100h
 hlt
\ No newline at end of file
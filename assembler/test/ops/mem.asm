@@ -0,0 +1,14 @@
+mov src, r1
+mov dst, r2
+mov 6, r3
+mcpy r2, r1, r3 ; dst = "Hello\0"
+mov '!', r4
+mov 1, r5
+mset r2, r4, r5 ; dst = "!ello\0"
+mcmp r1, r2, r3 ; "Hello" > "!ello"
+mov 'l', r4
+mchr r2, r4, r3 ; r2 = dst + 2
+hlt
+
+src: u8 "Hello\0"
+dst: u8 0 0 0 0 0 0
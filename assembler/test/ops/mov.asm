@@ -33,5 +33,15 @@ mov8 r1, [r2]
 mov16 r1, [r2]
 mov32 r1, [r2]
 mov64 r1, [r2]
+mov [r1 + r2*8 + 16], r3
+mov8 [r1 + r2], r3
+mov16 [r1 + r2*2], r3
+mov32 [r1 + r2*4 - 4], r3
+mov64 [r1 + 8], r3
+mov r3, [r1 + r2*8 + 16]
+mov8 r3, [r1 + r2]
+mov16 r3, [r1 + r2*2]
+mov32 r3, [r1 + r2*4 - 4]
+mov64 r3, [r1 + 8]
 mov r1, r2
 hlt
\ No newline at end of file
@@ -4,4 +4,6 @@ mulf32 r1, 10
 mulf32 r1, 10
 mulf64 r1, r2
 mulf64 r1, r2
+mulh r1, r2
+mulhu r1, r2
 hlt
\ No newline at end of file
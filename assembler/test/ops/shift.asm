@@ -4,4 +4,8 @@ sll r2, 3
 sll r2, r3
 slr r2, 3
 slr r2, r3
+rol r2, 3
+rol r2, r3
+ror r2, 3
+ror r2, r3
 hlt
\ No newline at end of file
@@ -5,4 +5,5 @@ subf32 r1, 10
 subf64 r1, r2
 subf64 r1, r2
 sub 128, [200], [328]
+sub r1, [r2 + r3*8 + 8]
 hlt
\ No newline at end of file
@@ -0,0 +1,14 @@
+; Assemble with -O: each instruction marked "removed" has no effect
+mov 5, r1
+mov r1, r1 ; removed
+add r1, 0 ; removed
+mov 0, r0
+syscall
+mov 0, r0 ; removed: r0 already holds 0
+syscall
+jmp end ; removed: jumps to the next instruction
+end:
+mov data, r2 ; Moved to the new address of data
+hlt
+
+data: u64 42
@@ -0,0 +1,14 @@
+; Assemble with -O: literals and jumps are given shorter encodings
+main:
+    mov 0, r1 ; mov8
+loop:
+    add r1, 1
+    cmp r1, 300
+    jeq out ; Relative jump, 16-bit offset
+    jmp loop
+out:
+    mov 70000, r2 ; mov32
+    add r1, r2
+    mov 0, r0 ; mov8
+    syscall ; Prints 70300
+    hlt
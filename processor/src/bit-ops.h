@@ -7,6 +7,19 @@
 
 #include "util.h"
 
+// Bit-manipulation primitives on an unsigned 64-bit word, mapped to compiler
+// builtins. CLZ/CTZ of zero is 64; rotate amounts are taken modulo 64.
+#define BIT_POPCOUNT(x) ((T_u64)__builtin_popcountll(x))
+#define BIT_CLZ(x) ((x) ? (T_u64)__builtin_clzll(x) : 64)
+#define BIT_CTZ(x) ((x) ? (T_u64)__builtin_ctzll(x) : 64)
+#define BIT_BSWAP(x) ((T_u64)__builtin_bswap64(x))
+#define BIT_ROTL(x, n) (((x) << ((n) & 63)) | ((x) >> (-(n) & 63)))
+#define BIT_ROTR(x, n) (((x) >> ((n) & 63)) | ((x) << (-(n) & 63)))
+
+// High 64 bits of the 128-bit product of two words
+#define BIT_MULHI(a, b) ((T_u64)(((__int128)(T_i64)(a) * (T_i64)(b)) >> 64))
+#define BIT_UMULHI(a, b) ((T_u64)(((unsigned __int128)(a) * (b)) >> 64))
+
 /** Bitwise NOT a sequence of bytes in place */
 void bitwise_not(void *data, T_u8 bytes);
 
@@ -517,6 +517,30 @@ int cpu_execute_opcode(CPU cpu, OPCODE_T opcode, WORD_T *ip) {
         case OP_LLSHIFT_REG:
         OP_REG_REG(<<, *ip, WORD_T, )
             return 1;
+        case OP_ROTL_LIT:
+        OP_REG_LIT_FN(BIT_ROTL, *ip, T_u8)
+            return 1;
+        case OP_ROTL_REG:
+        OP_REG_REG_FN(BIT_ROTL, *ip)
+            return 1;
+        case OP_ROTR_LIT:
+        OP_REG_LIT_FN(BIT_ROTR, *ip, T_u8)
+            return 1;
+        case OP_ROTR_REG:
+        OP_REG_REG_FN(BIT_ROTR, *ip)
+            return 1;
+        case OP_POPCNT:
+        OP_REG_FN(BIT_POPCOUNT, *ip)
+            return 1;
+        case OP_CLZ:
+        OP_REG_FN(BIT_CLZ, *ip)
+            return 1;
+        case OP_CTZ:
+        OP_REG_FN(BIT_CTZ, *ip)
+            return 1;
+        case OP_BSWAP:
+        OP_REG_FN(BIT_BSWAP, *ip)
+            return 1;
         case OP_CVT_i8_i16:
         OP_CVT(*ip, T_i8, T_i16)
             return 1;
@@ -625,6 +649,12 @@ int cpu_execute_opcode(CPU cpu, OPCODE_T opcode, WORD_T *ip) {
         case OP_MULF64_REG_REG:
         OP_REG_REG(*, *ip, T_f64, )
             return 1;
+        case OP_MULHI_REG_REG:
+        OP_REG_REG_FN(BIT_MULHI, *ip)
+            return 1;
+        case OP_UMULHI_REG_REG:
+        OP_REG_REG_FN(BIT_UMULHI, *ip)
+            return 1;
         case OP_DIV_REG_LIT:
         OP_REG_LIT_REG(/, %, *ip, WORD_T, REG_FLAG)
             return 1;
@@ -709,6 +739,87 @@ int cpu_execute_opcode(CPU cpu, OPCODE_T opcode, WORD_T *ip) {
         case OP_JMP_NEQ_REG:
         JMP_REG_IF(*ip, !=, CMP_EQ)
             return 1;
+        case OP_JMP_DEC_NZ:
+        JMP_DEC_NZ(*ip)
+            return 1;
+        case OP_JMP_EQ_REG_LIT:
+        JMP_CMP_REG_LIT(*ip, ==, CMP_EQ)
+            return 1;
+        case OP_JMP_EQ_REG_REG:
+        JMP_CMP_REG_REG(*ip, ==, CMP_EQ)
+            return 1;
+        case OP_JMP_GT_REG_LIT:
+        JMP_CMP_REG_LIT(*ip, ==, CMP_GT)
+            return 1;
+        case OP_JMP_GT_REG_REG:
+        JMP_CMP_REG_REG(*ip, ==, CMP_GT)
+            return 1;
+        case OP_JMP_GE_REG_LIT:
+        JMP_CMP_REG_LIT(*ip, >, CMP_LT)
+            return 1;
+        case OP_JMP_GE_REG_REG:
+        JMP_CMP_REG_REG(*ip, >, CMP_LT)
+            return 1;
+        case OP_JMP_LT_REG_LIT:
+        JMP_CMP_REG_LIT(*ip, ==, CMP_LT)
+            return 1;
+        case OP_JMP_LT_REG_REG:
+        JMP_CMP_REG_REG(*ip, ==, CMP_LT)
+            return 1;
+        case OP_JMP_LE_REG_LIT:
+        JMP_CMP_REG_LIT(*ip, <, CMP_GT)
+            return 1;
+        case OP_JMP_LE_REG_REG:
+        JMP_CMP_REG_REG(*ip, <, CMP_GT)
+            return 1;
+        case OP_JMP_NEQ_REG_LIT:
+        JMP_CMP_REG_LIT(*ip, !=, CMP_EQ)
+            return 1;
+        case OP_JMP_NEQ_REG_REG:
+        JMP_CMP_REG_REG(*ip, !=, CMP_EQ)
+            return 1;
+        case OP_JMP_REL16:
+        JMP_REL(*ip, T_i16)
+            return 1;
+        case OP_JMP_REL32:
+        JMP_REL(*ip, T_i32)
+            return 1;
+        case OP_JMP_EQ_REL16:
+        JMP_REL_IF(*ip, ==, CMP_EQ, T_i16)
+            return 1;
+        case OP_JMP_EQ_REL32:
+        JMP_REL_IF(*ip, ==, CMP_EQ, T_i32)
+            return 1;
+        case OP_JMP_GT_REL16:
+        JMP_REL_IF(*ip, ==, CMP_GT, T_i16)
+            return 1;
+        case OP_JMP_GT_REL32:
+        JMP_REL_IF(*ip, ==, CMP_GT, T_i32)
+            return 1;
+        case OP_JMP_GE_REL16:
+        JMP_REL_IF(*ip, >, CMP_LT, T_i16)
+            return 1;
+        case OP_JMP_GE_REL32:
+        JMP_REL_IF(*ip, >, CMP_LT, T_i32)
+            return 1;
+        case OP_JMP_LT_REL16:
+        JMP_REL_IF(*ip, ==, CMP_LT, T_i16)
+            return 1;
+        case OP_JMP_LT_REL32:
+        JMP_REL_IF(*ip, ==, CMP_LT, T_i32)
+            return 1;
+        case OP_JMP_LE_REL16:
+        JMP_REL_IF(*ip, <, CMP_GT, T_i16)
+            return 1;
+        case OP_JMP_LE_REL32:
+        JMP_REL_IF(*ip, <, CMP_GT, T_i32)
+            return 1;
+        case OP_JMP_NEQ_REL16:
+        JMP_REL_IF(*ip, !=, CMP_EQ, T_i16)
+            return 1;
+        case OP_JMP_NEQ_REL32:
+        JMP_REL_IF(*ip, !=, CMP_EQ, T_i32)
+            return 1;
         case OP_PUSH_LIT:
         PUSH_LIT(*ip, WORD_T)
             return 1;
@@ -760,21 +871,60 @@ int cpu_execute_opcode(CPU cpu, OPCODE_T opcode, WORD_T *ip) {
         case OP_PUSH64_REG:
         PUSH_REG(*ip, T_u64)
             return 1;
+        case OP_PUSH_REGPTR:
+        PUSH_REGPTR(*ip, WORD_T)
+            return 1;
+        case OP_PUSH8_REGPTR:
+        PUSH_REGPTR(*ip, T_u8)
+            return 1;
+        case OP_PUSH16_REGPTR:
+        PUSH_REGPTR(*ip, T_u16)
+            return 1;
+        case OP_PUSH32_REGPTR:
+        PUSH_REGPTR(*ip, T_u32)
+            return 1;
+        case OP_PUSH64_REGPTR:
+        PUSH_REGPTR(*ip, T_u64)
+            return 1;
+        case OP_PUSHN_REGPTR:
+        PUSHN_REGPTR(*ip)
+            return 1;
         case OP_POP_REG:
         POP_REG(*ip, WORD_T)
             return 1;
         case OP_POP8_REG:
         POP_REG(*ip, T_u8)
+            return 1;
         case OP_POP16_REG:
         POP_REG(*ip, T_u16)
+            return 1;
         case OP_POP32_REG:
         POP_REG(*ip, T_u32)
+            return 1;
         case OP_POP64_REG:
         POP_REG(*ip, T_u64)
             return 1;
         case OP_POPN_MEM:
         POPN_MEM(*ip)
             return 1;
+        case OP_POP_REGPTR:
+        POP_REGPTR(*ip, WORD_T)
+            return 1;
+        case OP_POP8_REGPTR:
+        POP_REGPTR(*ip, T_u8)
+            return 1;
+        case OP_POP16_REGPTR:
+        POP_REGPTR(*ip, T_u16)
+            return 1;
+        case OP_POP32_REGPTR:
+        POP_REGPTR(*ip, T_u32)
+            return 1;
+        case OP_POP64_REGPTR:
+        POP_REGPTR(*ip, T_u64)
+            return 1;
+        case OP_POPN_REGPTR:
+        POPN_REGPTR(*ip)
+            return 1;
         case OP_CALL_LIT: {
             WORD_T lit = MEM_READ(*ip, WORD_T);
             *ip += sizeof(WORD_T);
@@ -794,6 +944,54 @@ int cpu_execute_opcode(CPU cpu, OPCODE_T opcode, WORD_T *ip) {
         case OP_RET:
             cpu_pop_stack_frame(cpu);
             return 1;
+        case OP_MEMCPY:
+        MEMCPY_REG(*ip)
+            return 1;
+        case OP_MEMSET:
+        MEMSET_REG(*ip)
+            return 1;
+        case OP_MEMCMP:
+        MEMCMP_REG(*ip)
+            return 1;
+        case OP_MEMCHR:
+        MEMCHR_REG(*ip)
+            return 1;
+        case OP_MOV_IDX_REG:
+        MOV_IDX_REG(*ip, WORD_T)
+            return 1;
+        case OP_MOV8_IDX_REG:
+        MOV_IDX_REG(*ip, T_u8)
+            return 1;
+        case OP_MOV16_IDX_REG:
+        MOV_IDX_REG(*ip, T_u16)
+            return 1;
+        case OP_MOV32_IDX_REG:
+        MOV_IDX_REG(*ip, T_u32)
+            return 1;
+        case OP_MOV64_IDX_REG:
+        MOV_IDX_REG(*ip, T_u64)
+            return 1;
+        case OP_MOV_REG_IDX:
+        MOV_REG_IDX(*ip, WORD_T)
+            return 1;
+        case OP_MOV8_REG_IDX:
+        MOV_REG_IDX(*ip, T_u8)
+            return 1;
+        case OP_MOV16_REG_IDX:
+        MOV_REG_IDX(*ip, T_u16)
+            return 1;
+        case OP_MOV32_REG_IDX:
+        MOV_REG_IDX(*ip, T_u32)
+            return 1;
+        case OP_MOV64_REG_IDX:
+        MOV_REG_IDX(*ip, T_u64)
+            return 1;
+        case OP_ADD_REG_IDX:
+        OP_REG_IDX(+, *ip)
+            return 1;
+        case OP_SUB_REG_IDX:
+        OP_REG_IDX(-, *ip)
+            return 1;
         case OP_PRINT_HEX_MEM:
             OP_APPLYF_MEM(*ip, print_bytes, )
             return 1;
@@ -511,7 +511,65 @@ void cpu_err_print(CPU cpu);
         if (cpu->regs[REG_CMP] op flag) \
             SET_REG(ip, ip, UWORD_T)    \
         else                            \
-            ip += sizeof(UWORD_T);      \
+            ip += sizeof(T_u8);         \
+    }
+
+// Jump by an offset of type `type`, relative to the following instruction
+#define JMP_REL(ip, type)                                          \
+    {                                                              \
+        UWORD_T addr = ip + sizeof(type) + MEM_READ(ip, type);     \
+        ERR_CHECK_ADDR(addr) else                                  \
+            ip = addr;                                             \
+    }
+
+// Jump by a relative offset of type `type` if `REG_CMP op flag` is true
+#define JMP_REL_IF(ip, op, flag, type)  \
+    {                                   \
+        if (cpu->regs[REG_CMP] op flag) \
+            JMP_REL(ip, type)           \
+        else                            \
+            ip += sizeof(type);         \
+    }
+
+// Compare register with a literal, then jump to a literal if
+// `REG_CMP op flag` is true
+#define JMP_CMP_REG_LIT(ip, op, flag)                                   \
+    {                                                                   \
+        T_u8 reg = MEM_READ(ip, T_u8);                                  \
+        ERR_CHECK_REG(reg) else {                                       \
+            ip += sizeof(T_u8);                                         \
+            WORD_T lit = MEM_READ(ip, WORD_T);                          \
+            ip += sizeof(WORD_T);                                       \
+            cpu->regs[REG_CMP] = CMP(cpu->regs[reg], lit);              \
+            JMP_LIT_IF(ip, op, flag)                                    \
+        }                                                               \
+    }
+
+// Compare two registers, then jump to a literal if `REG_CMP op flag` is true
+#define JMP_CMP_REG_REG(ip, op, flag)                                   \
+    {                                                                   \
+        T_u8 r1 = MEM_READ(ip, T_u8);                                   \
+        T_u8 r2 = MEM_READ(ip + 1, T_u8);                               \
+        ERR_CHECK_REG(r1)                                               \
+        else ERR_CHECK_REG(r2)                                          \
+        else {                                                          \
+            ip += 2 * sizeof(T_u8);                                     \
+            cpu->regs[REG_CMP] = CMP(cpu->regs[r1], cpu->regs[r2]);     \
+            JMP_LIT_IF(ip, op, flag)                                    \
+        }                                                               \
+    }
+
+// Decrement register, then jump to a literal if it is non-zero
+#define JMP_DEC_NZ(ip)                                                  \
+    {                                                                   \
+        T_u8 reg = MEM_READ(ip, T_u8);                                  \
+        ERR_CHECK_REG(reg) else {                                       \
+            ip += sizeof(T_u8);                                         \
+            if (--cpu->regs[reg] != 0)                                  \
+                SET_LIT(ip, ip, UWORD_T)                                \
+            else                                                        \
+                ip += sizeof(UWORD_T);                                  \
+        }                                                               \
     }
 
 // Push a value onto the stack
@@ -599,6 +657,42 @@ void cpu_err_print(CPU cpu);
         ERR_CHECK_STACK_OFLOW();                                           \
     }
 
+// Push value at memory address stored in register onto the stack
+#define PUSH_REGPTR(ip, type)                           \
+    {                                                   \
+        ERR_CHECK_STACK_OFLOW() else {                  \
+            T_u8 reg = MEM_READ(ip, T_u8);              \
+            ERR_CHECK_REG(reg) else {                   \
+                UWORD_T addr = cpu->regs[reg];          \
+                ERR_CHECK_RANGE(addr, sizeof(type)) else { \
+                    ip += sizeof(T_u8);                 \
+                    PUSH(type, MEM_READ(addr, type));   \
+                }                                       \
+            }                                           \
+        }                                               \
+    }
+
+// Push n-bytes at address stored in register to the stack:
+// `<bytes: u8> <regptr: u8>`. Byte order matches PUSHN_MEM.
+#define PUSHN_REGPTR(ip)                                                    \
+    {                                                                       \
+        ERR_CHECK_STACK_OFLOW() else {                                      \
+            T_u8 nbytes = MEM_READ(ip, T_u8);                               \
+            T_u8 reg = MEM_READ(ip + 1, T_u8);                              \
+            ERR_CHECK_REG(reg) else {                                       \
+                ip += 2 * sizeof(T_u8);                                     \
+                UWORD_T addr = cpu->regs[reg];                              \
+                ERR_CHECK_RANGE(addr, nbytes) else {                        \
+                    T_u8 *top = (T_u8 *)cpu->mem + cpu->regs[REG_SP];       \
+                    for (UWORD_T off = 0; off < nbytes; ++off)              \
+                        *(top - 1 - off) = *((T_u8 *)cpu->mem + addr + off); \
+                    cpu->regs[REG_SP] -= nbytes;                            \
+                    ERR_CHECK_STACK_OFLOW();                                \
+                }                                                           \
+            }                                                               \
+        }                                                                   \
+    }
+
 // Pop value `type` from stack. Set to `var`.
 #define POP(type, var)                                     \
     var = *(type *)((T_u8 *)cpu->mem + cpu->regs[REG_SP]); \
@@ -613,7 +707,7 @@ void cpu_err_print(CPU cpu);
             ip += sizeof(T_u8);               \
             type val;                         \
             POP(type, val);                   \
-            *(type *)(cpu->regs + reg) = val; \
+            cpu->regs[reg] = val;             \
         }                                     \
     }
 
@@ -635,6 +729,177 @@ void cpu_err_print(CPU cpu);
         }                                             \
     }
 
+// Pop `type` off stack and write to memory address stored in register
+#define POP_REGPTR(ip, type)                               \
+    {                                                      \
+        T_u8 reg = MEM_READ(ip, T_u8);                     \
+        ERR_CHECK_REG(reg) else {                          \
+            UWORD_T addr = cpu->regs[reg];                 \
+            ERR_CHECK_RANGE(addr, sizeof(type)) else {     \
+                ip += sizeof(T_u8);                        \
+                type val;                                  \
+                POP(type, val);                            \
+                MEM_WRITEK(addr, type, val);               \
+            }                                              \
+        }                                                  \
+    }
+
+// Pop n-bytes from stack and write to memory address stored in register:
+// `<bytes: u8> <regptr: u8>`. Byte order matches POPN_MEM.
+#define POPN_REGPTR(ip)                                                    \
+    {                                                                      \
+        T_u8 nbytes = MEM_READ(ip, T_u8);                                  \
+        T_u8 reg = MEM_READ(ip + 1, T_u8);                                 \
+        ERR_CHECK_REG(reg) else {                                          \
+            ip += 2 * sizeof(T_u8);                                        \
+            UWORD_T addr = cpu->regs[reg];                                 \
+            ERR_CHECK_RANGE(addr, nbytes)                                  \
+            else if (cpu->regs[REG_SP] + nbytes > cpu->mem_size) {         \
+                ERR_SET(ERR_STACK_UFLOW, 0);                               \
+            } else {                                                       \
+                memmove((T_u8 *)cpu->mem + addr,                           \
+                        (T_u8 *)cpu->mem + cpu->regs[REG_SP], nbytes);     \
+                cpu->regs[REG_SP] += nbytes;                               \
+            }                                                              \
+        }                                                                  \
+    }
+
+// Instruction syntax `<r1: u8> <r2: u8> <r3: u8>`. Execute `body` with `a`, `b`
+// and `n` set to the contents of each register.
+#define OP_BLOCK(ip, body)                                     \
+    {                                                          \
+        T_u8 r1 = MEM_READ(ip, T_u8);                          \
+        T_u8 r2 = MEM_READ(ip + 1, T_u8);                      \
+        T_u8 r3 = MEM_READ(ip + 2, T_u8);                      \
+        ERR_CHECK_REG(r1)                                      \
+        else ERR_CHECK_REG(r2)                                 \
+        else ERR_CHECK_REG(r3)                                 \
+        else {                                                 \
+            ip += 3 * sizeof(T_u8);                            \
+            UWORD_T a = cpu->regs[r1];                         \
+            UWORD_T b = cpu->regs[r2];                         \
+            UWORD_T n = cpu->regs[r3];                         \
+            body                                               \
+        }                                                      \
+    }
+
+// Copy `n` bytes from address `b` to address `a`. Regions may overlap.
+#define MEMCPY_REG(ip)                                                   \
+    OP_BLOCK(ip, ERR_CHECK_RANGE(a, n) else ERR_CHECK_RANGE(b, n) else { \
+        memmove((T_u8 *)cpu->mem + a, (T_u8 *)cpu->mem + b, n);          \
+    })
+
+// Fill `n` bytes at address `a` with the low byte of `b`
+#define MEMSET_REG(ip)                                \
+    OP_BLOCK(ip, ERR_CHECK_RANGE(a, n) else {         \
+        memset((T_u8 *)cpu->mem + a, (T_u8)b, n);     \
+    })
+
+// Compare `n` bytes at addresses `a` and `b`, place result in REG_CMP
+#define MEMCMP_REG(ip)                                                         \
+    OP_BLOCK(ip, ERR_CHECK_RANGE(a, n) else ERR_CHECK_RANGE(b, n) else {       \
+        int res = memcmp((T_u8 *)cpu->mem + a, (T_u8 *)cpu->mem + b, n);       \
+        cpu->regs[REG_CMP] = res == 0 ? CMP_EQ : (res > 0 ? CMP_GT : CMP_LT);  \
+    })
+
+// Search `n` bytes at address `a` for the low byte of `b`. Set first register
+// to the address of the match, or -1.
+#define MEMCHR_REG(ip)                                                    \
+    OP_BLOCK(ip, ERR_CHECK_RANGE(a, n) else {                             \
+        T_u8 *found = memchr((T_u8 *)cpu->mem + a, (T_u8)b, n);           \
+        cpu->regs[r1] = found ? found - (T_u8 *)cpu->mem : -1;            \
+    })
+
+// Apply `fn` to a register as an unsigned word : reg = fn(reg)
+#define OP_REG_FN(fn, ip)                          \
+    {                                              \
+        T_u8 reg = MEM_READ(ip, T_u8);             \
+        ERR_CHECK_REG(reg) else {                  \
+            ip += sizeof(T_u8);                    \
+            T_u64 v = cpu->regs[reg];              \
+            cpu->regs[reg] = fn(v);                \
+        }                                          \
+    }
+
+// Apply `fn` to a register and literal as unsigned words : reg = fn(reg, lit)
+#define OP_REG_LIT_FN(fn, ip, litT)                \
+    {                                              \
+        T_u8 reg = MEM_READ(ip, T_u8);             \
+        ERR_CHECK_REG(reg) else {                  \
+            ip += sizeof(T_u8);                    \
+            T_u64 lit = MEM_READ(ip, litT);        \
+            ip += sizeof(litT);                    \
+            T_u64 v = cpu->regs[reg];              \
+            cpu->regs[reg] = fn(v, lit);           \
+        }                                          \
+    }
+
+// Apply `fn` to two registers as unsigned words : r1 = fn(r1, r2)
+#define OP_REG_REG_FN(fn, ip)                      \
+    {                                              \
+        T_u8 r1 = MEM_READ(ip, T_u8);              \
+        T_u8 r2 = MEM_READ(ip + 1, T_u8);          \
+        ERR_CHECK_REG(r1)                          \
+        else ERR_CHECK_REG(r2)                     \
+        else {                                     \
+            ip += 2 * sizeof(T_u8);                \
+            T_u64 a = cpu->regs[r1];               \
+            T_u64 b = cpu->regs[r2];               \
+            cpu->regs[r1] = fn(a, b);              \
+        }                                          \
+    }
+
+// Decode the indexed operand at `ip` into `addr`, then run `body`
+#define IDX_OPERAND(ip, body)                                       \
+    {                                                               \
+        T_u8 base = MEM_READ(ip, T_u8);                             \
+        T_u8 index = MEM_READ(ip + 1, T_u8);                        \
+        ERR_CHECK_REG(base)                                         \
+        else ERR_CHECK_REG(index)                                   \
+        else {                                                      \
+            UWORD_T addr = cpu->regs[base] +                        \
+                           cpu->regs[index] * MEM_READ(ip + 2, T_u8) + \
+                           (WORD_T)MEM_READ(ip + 3, T_i32);         \
+            ip += 3 * sizeof(T_u8) + sizeof(T_i32);                 \
+            body                                                    \
+        }                                                           \
+    }
+
+// Move value of type `type` at indexed address `ip` to register at `ip+7`
+#define MOV_IDX_REG(ip, type)                                       \
+    IDX_OPERAND(ip, {                                               \
+        T_u8 reg = MEM_READ(ip, T_u8);                              \
+        ERR_CHECK_REG(reg)                                          \
+        else ERR_CHECK_RANGE(addr, sizeof(type))                    \
+        else {                                                      \
+            ip += sizeof(T_u8);                                     \
+            cpu->regs[reg] = MEM_READ(addr, type);                  \
+        }                                                           \
+    })
+
+// Move value of type `type` from register at `ip` to indexed address at `ip+1`
+#define MOV_REG_IDX(ip, type)                                       \
+    {                                                               \
+        T_u8 reg = MEM_READ(ip, T_u8);                              \
+        ERR_CHECK_REG(reg) else {                                   \
+            ip += sizeof(T_u8);                                     \
+            IDX_OPERAND(ip, ERR_CHECK_RANGE(addr, sizeof(type))     \
+            else MEM_WRITEK(addr, type, cpu->regs[reg]);)           \
+        }                                                           \
+    }
+
+// Perform operation between register and value at indexed address :
+// reg = reg op [indexed]
+#define OP_REG_IDX(op, ip)                                          \
+    {                                                               \
+        T_u8 reg = MEM_READ(ip, T_u8);                              \
+        ERR_CHECK_REG(reg) else {                                   \
+            ip += sizeof(T_u8);                                     \
+            IDX_OPERAND(ip, ERR_CHECK_RANGE(addr, sizeof(WORD_T))   \
+            else cpu->regs[reg] = cpu->regs[reg] op MEM_READ(addr, WORD_T);) \
+        }                                                           \
+    }
+
 // Print register as `type` via printf() using the provided formatting flag
 #define PRINT_REG(ip, type, flag)                     \
     {                                                 \
@@ -24,6 +24,12 @@
         ERR_SET(ERR_MEMOOB, addr); \
     }
 
+// MACRO - check that the `bytes`-long region starting at `addr` is in memory
+#define ERR_CHECK_RANGE(addr, bytes)                                       \
+    if ((bytes) > cpu->mem_size || (addr) > cpu->mem_size - (bytes)) {    \
+        ERR_SET(ERR_MEMOOB, addr);                                         \
+    }
+
 // Unknown register offset
 #define ERR_REG 2
 
@@ -460,6 +460,46 @@
 // Syntax: `jne <reg: u8>`
 #define OP_JMP_NEQ_REG 0x00ED
 
+// Decrement register, then jump to provided memory address IF register is
+// non-zero (set IP). Syntax: `djnz <reg: u8> <lit: uword>`
+#define OP_JMP_DEC_NZ 0x00F0
+// Compare register with literal, then jump to provided memory address IF
+// comparison is CMP_EQ (set IP). Syntax: `jeq <reg: u8> <lit: word> <lit: uword>`
+#define OP_JMP_EQ_REG_LIT 0x00F1
+// Compare two registers, then jump to provided memory address IF comparison
+// is CMP_EQ (set IP). Syntax: `jeq <reg: u8> <reg: u8> <lit: uword>`
+#define OP_JMP_EQ_REG_REG 0x00F2
+// Compare register with literal, then jump to provided memory address IF
+// comparison is CMP_GT (set IP). Syntax: `jgt <reg: u8> <lit: word> <lit: uword>`
+#define OP_JMP_GT_REG_LIT 0x00F3
+// Compare two registers, then jump to provided memory address IF comparison
+// is CMP_GT (set IP). Syntax: `jgt <reg: u8> <reg: u8> <lit: uword>`
+#define OP_JMP_GT_REG_REG 0x00F4
+// Compare register with literal, then jump to provided memory address IF
+// comparison is CMP_GT or CMP_EQ (set IP). Syntax: `jge <reg: u8> <lit: word> <lit: uword>`
+#define OP_JMP_GE_REG_LIT 0x00F5
+// Compare two registers, then jump to provided memory address IF comparison
+// is CMP_GT or CMP_EQ (set IP). Syntax: `jge <reg: u8> <reg: u8> <lit: uword>`
+#define OP_JMP_GE_REG_REG 0x00F6
+// Compare register with literal, then jump to provided memory address IF
+// comparison is CMP_LT (set IP). Syntax: `jlt <reg: u8> <lit: word> <lit: uword>`
+#define OP_JMP_LT_REG_LIT 0x00F7
+// Compare two registers, then jump to provided memory address IF comparison
+// is CMP_LT (set IP). Syntax: `jlt <reg: u8> <reg: u8> <lit: uword>`
+#define OP_JMP_LT_REG_REG 0x00F8
+// Compare register with literal, then jump to provided memory address IF
+// comparison is CMP_LT or CMP_EQ (set IP). Syntax: `jle <reg: u8> <lit: word> <lit: uword>`
+#define OP_JMP_LE_REG_LIT 0x00F9
+// Compare two registers, then jump to provided memory address IF comparison
+// is CMP_LT or CMP_EQ (set IP). Syntax: `jle <reg: u8> <reg: u8> <lit: uword>`
+#define OP_JMP_LE_REG_REG 0x00FA
+// Compare register with literal, then jump to provided memory address IF
+// comparison is not CMP_EQ (set IP). Syntax: `jne <reg: u8> <lit: word> <lit: uword>`
+#define OP_JMP_NEQ_REG_LIT 0x00FB
+// Compare two registers, then jump to provided memory address IF comparison
+// is not CMP_EQ (set IP). Syntax: `jne <reg: u8> <reg: u8> <lit: uword>`
+#define OP_JMP_NEQ_REG_REG 0x00FC
+
 // Push literal to the stack
 // Syntax: `psh <lit: word>`
 #define OP_PUSH_LIT 0x0100
@@ -511,24 +551,24 @@
 // Push first 64-bits of a register to the stack
 // Syntax: `psh64 <reg: u8>`
 #define OP_PUSH64_REG 0x0110
-//// Push value at memory address stored in register to the stack
-//// Syntax: `psh <regptr: u8>`
-//#define OP_PUSH_REGPTR 0x0111
-//// Push 8-bit value at memory address stored in register to the stack
-//// Syntax: `psh8 <regptr: u8>`
-//#define OP_PUSH8_REGPTR 0x0112
-//// Push 16-bit value at memory address stored in register to the stack
-//// Syntax: `psh16 <regptr: u8>`
-//#define OP_PUSH16_REGPTR 0x0113
-//// Push 32-bit value at memory address stored in register to the stack
-//// Syntax: `psh32 <regptr: u8>`
-//#define OP_PUSH32_REGPTR 0x0114
-//// Push 64-bit value at memory address stored in register to the stack
-//// Syntax: `psh64 <regptr: u8>`
-//#define OP_PUSH64_REGPTR 0x0115
-//// Push (n*8)-bit value at memory address stored in register to the stack
-//// Syntax: `psh <bytes: u8> <regptr: ...>`
-//#define OP_PUSHN_REGPTR 0x0116
+// Push value at memory address stored in register to the stack
+// Syntax: `psh <regptr: u8>`
+#define OP_PUSH_REGPTR 0x0111
+// Push 8-bit value at memory address stored in register to the stack
+// Syntax: `psh8 <regptr: u8>`
+#define OP_PUSH8_REGPTR 0x0112
+// Push 16-bit value at memory address stored in register to the stack
+// Syntax: `psh16 <regptr: u8>`
+#define OP_PUSH16_REGPTR 0x0113
+// Push 32-bit value at memory address stored in register to the stack
+// Syntax: `psh32 <regptr: u8>`
+#define OP_PUSH32_REGPTR 0x0114
+// Push 64-bit value at memory address stored in register to the stack
+// Syntax: `psh64 <regptr: u8>`
+#define OP_PUSH64_REGPTR 0x0115
+// Push (n*8)-bit value at memory address stored in register to the stack
+// Syntax: `psh <bytes: u8> <regptr: u8>`
+#define OP_PUSHN_REGPTR 0x0116
 
 // Pop word from stack and place in register
 // Syntax: `pop <reg: u8>`
@@ -548,24 +588,24 @@
 // Pop (n*8)-bits from stack and write to memory address
 // Syntax: `pop <bytes: u8> <addr: uword>`
 #define OP_POPN_MEM 0x0125
-//// Pop word from the stack and place in address in register
-//// Syntax: `pop <regptr: u8>`
-//#define OP_POP_REGPTR 0x0126
-//// Pop 8-bit value from the stack and place in address in register
-//// Syntax: `pop8 <regptr: u8>`
-//#define OP_POP8_REGPTR 0x0127
-//// Pop 16-bit value from the stack and place in address in register
-//// Syntax: `pop16 <regptr: u8>`
-//#define OP_POP16_REGPTR 0x0128
-//// Pop 32-bit value from the stack and place in address in register
-//// Syntax: `pop32 <regptr: u8>`
-//#define OP_POP32_REGPTR 0x0129
-//// Pop 64-bit value from the stack and place in address in register
-//// Syntax: `pop64 <regptr: u8>`
-//#define OP_POP64_REGPTR 0x012A
-//// Pop (n*8)-bit value from the stack and place in address in register
-//// Syntax: `pop <bytes: u8> <regptr: u8>`
-//#define OP_POPN_REGPTR 0x012B
+// Pop word from the stack and place in address in register
+// Syntax: `pop <regptr: u8>`
+#define OP_POP_REGPTR 0x0126
+// Pop 8-bit value from the stack and place in address in register
+// Syntax: `pop8 <regptr: u8>`
+#define OP_POP8_REGPTR 0x0127
+// Pop 16-bit value from the stack and place in address in register
+// Syntax: `pop16 <regptr: u8>`
+#define OP_POP16_REGPTR 0x0128
+// Pop 32-bit value from the stack and place in address in register
+// Syntax: `pop32 <regptr: u8>`
+#define OP_POP32_REGPTR 0x0129
+// Pop 64-bit value from the stack and place in address in register
+// Syntax: `pop64 <regptr: u8>`
+#define OP_POP64_REGPTR 0x012A
+// Pop (n*8)-bit value from the stack and place in address in register
+// Syntax: `pop <bytes: u8> <regptr: u8>`
+#define OP_POPN_REGPTR 0x012B
 
 // Call literal
 // Syntax: `cal <lit: uword>`
@@ -580,4 +620,133 @@
 // Syntax: `ret`
 #define OP_RET 0x0139
 
+// Copy `[r3]` bytes from address in r2 to address in r1. Regions may overlap.
+// Syntax: `mcpy <dest: reg> <src: reg> <bytes: reg>`
+#define OP_MEMCPY 0x0140
+// Fill `[r3]` bytes at address in r1 with the low byte of r2.
+// Syntax: `mset <dest: reg> <byte: reg> <bytes: reg>`
+#define OP_MEMSET 0x0141
+// Compare `[r3]` bytes at addresses in r1 and r2 (lexicographically), place
+// result in REG_CMP. Syntax: `mcmp <addr1: reg> <addr2: reg> <bytes: reg>`
+#define OP_MEMCMP 0x0142
+// Search `[r3]` bytes at address in r1 for the low byte of r2. Set r1 to the
+// address of the first match, or -1. Syntax: `mchr <addr: reg> <byte: reg> <bytes: reg>`
+#define OP_MEMCHR 0x0143
+
+// Indexed operands are encoded as `<base: u8> <index: u8> <scale: u8> <disp: i32>`
+// and address [base + index * scale + disp]. A scale of 0 means no index register.
+
+// Move value stored at indexed address into register
+// Syntax: `mov <indexed> <reg: u8>`
+#define OP_MOV_IDX_REG 0x0150
+// Move 8-bit value stored at indexed address into register
+// Syntax: `mov8 <indexed> <reg: u8>`
+#define OP_MOV8_IDX_REG 0x0151
+// Move 16-bit value stored at indexed address into register
+// Syntax: `mov16 <indexed> <reg: u8>`
+#define OP_MOV16_IDX_REG 0x0152
+// Move 32-bit value stored at indexed address into register
+// Syntax: `mov32 <indexed> <reg: u8>`
+#define OP_MOV32_IDX_REG 0x0153
+// Move 64-bit value stored at indexed address into register
+// Syntax: `mov64 <indexed> <reg: u8>`
+#define OP_MOV64_IDX_REG 0x0154
+// Move value in register to indexed address
+// Syntax: `mov <reg: u8> <indexed>`
+#define OP_MOV_REG_IDX 0x0155
+// Move 8-bit value in register to indexed address
+// Syntax: `mov8 <reg: u8> <indexed>`
+#define OP_MOV8_REG_IDX 0x0156
+// Move 16-bit value in register to indexed address
+// Syntax: `mov16 <reg: u8> <indexed>`
+#define OP_MOV16_REG_IDX 0x0157
+// Move 32-bit value in register to indexed address
+// Syntax: `mov32 <reg: u8> <indexed>`
+#define OP_MOV32_REG_IDX 0x0158
+// Move 64-bit value in register to indexed address
+// Syntax: `mov64 <reg: u8> <indexed>`
+#define OP_MOV64_REG_IDX 0x0159
+// Add value at indexed address to register : reg = reg + [indexed]
+// Syntax: `add <reg: u8> <indexed>`
+#define OP_ADD_REG_IDX 0x015A
+// Subtract value at indexed address from register : reg = reg - [indexed]
+// Syntax: `sub <reg: u8> <indexed>`
+#define OP_SUB_REG_IDX 0x015B
+
+// Count set bits in a register : reg = popcount(reg)
+// Syntax: `popc <reg: u8>`
+#define OP_POPCNT 0x0160
+// Count leading zero bits in a register (64 if zero) : reg = clz(reg)
+// Syntax: `clz <reg: u8>`
+#define OP_CLZ 0x0161
+// Count trailing zero bits in a register (64 if zero) : reg = ctz(reg)
+// Syntax: `ctz <reg: u8>`
+#define OP_CTZ 0x0162
+// Reverse byte order of a register
+// Syntax: `bswp <reg: u8>`
+#define OP_BSWAP 0x0163
+// Rotate register left by a literal : reg = reg rotl lit
+// Syntax: `rol <reg: u8> <lit: u8>`
+#define OP_ROTL_LIT 0x0164
+// Rotate register left by another register : r1 = r1 rotl r2
+// Syntax: `rol <reg: u8> <reg: u8>`
+#define OP_ROTL_REG 0x0165
+// Rotate register right by a literal : reg = reg rotr lit
+// Syntax: `ror <reg: u8> <lit: u8>`
+#define OP_ROTR_LIT 0x0166
+// Rotate register right by another register : r1 = r1 rotr r2
+// Syntax: `ror <reg: u8> <reg: u8>`
+#define OP_ROTR_REG 0x0167
+// Signed multiply, keeping the high 64 bits of the 128-bit product : r1 = (r1 * r2) >> 64
+// Syntax: `mulh <reg: u8> <reg: u8>`
+#define OP_MULHI_REG_REG 0x0168
+// Unsigned multiply, keeping the high 64 bits of the 128-bit product : r1 = (r1 * r2) >> 64
+// Syntax: `mulhu <reg: u8> <reg: u8>`
+#define OP_UMULHI_REG_REG 0x0169
+
+// Short jumps are only emitted by the assembler's branch relaxation (`-O`); the offset is added to the address of the
+// following instruction
+// Jump execution to an address relative to the next instruction (set IP)
+// Syntax: `jmp <off: i16>`
+#define OP_JMP_REL16 0x0170
+// Jump execution to an address relative to the next instruction (set IP)
+// Syntax: `jmp <off: i32>`
+#define OP_JMP_REL32 0x0171
+// Jump execution to an address relative to the next instruction IF comparison is CMP_EQ (set IP)
+// Syntax: `jeq <off: i16>`
+#define OP_JMP_EQ_REL16 0x0172
+// Jump execution to an address relative to the next instruction IF comparison is CMP_EQ (set IP)
+// Syntax: `jeq <off: i32>`
+#define OP_JMP_EQ_REL32 0x0173
+// Jump execution to an address relative to the next instruction IF comparison is CMP_GT (set IP)
+// Syntax: `jgt <off: i16>`
+#define OP_JMP_GT_REL16 0x0174
+// Jump execution to an address relative to the next instruction IF comparison is CMP_GT (set IP)
+// Syntax: `jgt <off: i32>`
+#define OP_JMP_GT_REL32 0x0175
+// Jump execution to an address relative to the next instruction IF comparison is CMP_GT or CMP_EQ (set IP)
+// Syntax: `jge <off: i16>`
+#define OP_JMP_GE_REL16 0x0176
+// Jump execution to an address relative to the next instruction IF comparison is CMP_GT or CMP_EQ (set IP)
+// Syntax: `jge <off: i32>`
+#define OP_JMP_GE_REL32 0x0177
+// Jump execution to an address relative to the next instruction IF comparison is CMP_LT (set IP)
+// Syntax: `jlt <off: i16>`
+#define OP_JMP_LT_REL16 0x0178
+// Jump execution to an address relative to the next instruction IF comparison is CMP_LT (set IP)
+// Syntax: `jlt <off: i32>`
+#define OP_JMP_LT_REL32 0x0179
+// Jump execution to an address relative to the next instruction IF comparison is CMP_LT or CMP_EQ (set IP)
+// Syntax: `jle <off: i16>`
+#define OP_JMP_LE_REL16 0x017A
+// Jump execution to an address relative to the next instruction IF comparison is CMP_LT or CMP_EQ (set IP)
+// Syntax: `jle <off: i32>`
+#define OP_JMP_LE_REL32 0x017B
+// Jump execution to an address relative to the next instruction IF comparison is not CMP_EQ (set IP)
+// Syntax: `jne <off: i16>`
+#define OP_JMP_NEQ_REL16 0x017C
+// Jump execution to an address relative to the next instruction IF comparison is not CMP_EQ (set IP)
+// Syntax: `jne <off: i32>`
+#define OP_JMP_NEQ_REL32 0x017D
+
 #endif
\ No newline at end of file